@@ -0,0 +1,193 @@
+// Allocation Check
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Checks that the steps documented as allocation-free make no heap
+// allocations once they are warmed up:
+// - train (one sample at a time), with and without an optimizer
+// - trainBatch with a batch size seen before
+// - feedForwardInto and predictBatch with a context used before
+// - the same on a network large enough for its products to be split
+//   across the thread pool
+// Every allocation function (malloc and its relatives, which operator
+// new goes through, and mmap, which large matrices come from) is
+// replaced with one that counts its calls. Exits with 1 if any step
+// allocated.
+//
+//     make check
+//
+//========================================================================
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <atomic>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "neuralnet.hpp"
+#include "optimizer.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+// COUNTING ALLOCATOR
+// forwards to glibc's own entry points, counting every call
+
+extern "C" void* __libc_malloc (size_t size);
+extern "C" void* __libc_calloc (size_t count, size_t size);
+extern "C" void* __libc_realloc (void* data, size_t size);
+extern "C" void* __libc_memalign (size_t alignment, size_t size);
+
+static std::atomic<size_t> s_allocations (0);
+
+extern "C" void* malloc (size_t size)
+{
+    ++s_allocations;
+    return __libc_malloc (size);
+}
+
+extern "C" void* calloc (size_t count, size_t size)
+{
+    ++s_allocations;
+    return __libc_calloc (count, size);
+}
+
+extern "C" void* realloc (void* data, size_t size)
+{
+    ++s_allocations;
+    return __libc_realloc (data, size);
+}
+
+extern "C" void* aligned_alloc (size_t alignment, size_t size)
+{
+    ++s_allocations;
+    return __libc_memalign (alignment, size);
+}
+
+extern "C" int posix_memalign (void** data, size_t alignment, size_t size)
+{
+    ++s_allocations;
+    *data = __libc_memalign (alignment, size);
+    return *data ? 0 : ENOMEM;
+}
+
+extern "C" void* mmap (void* address, size_t size, int protection, int flags, int fd, off_t offset)
+{
+    ++s_allocations;
+    return (void*) syscall (SYS_mmap, address, size, protection, flags, fd, offset);
+}
+
+//========================================================================
+
+// Runs step count times after warming it up, prints the allocations
+// the timed steps made and returns true if there were none
+template <typename Step>
+static bool check (const char* name, size_t count, Step step)
+{
+    // the first calls size the network's memory (and the context's)
+    for (size_t i = 0; i < 4; ++i) {
+        step (i);
+    }
+    size_t before = s_allocations;
+    for (size_t i = 0; i < count; ++i) {
+        step (i);
+    }
+    size_t allocations = s_allocations - before;
+    printf ("%-40s %6lu allocations\n", name, allocations);
+    return allocations == 0;
+}
+
+//========================================================================
+
+int
+main ()
+{
+
+    const size_t steps = 1000;
+    const size_t batch = 16;
+    bool wasSuccessful = true;
+
+    printf ("Allocations over %lu steps after warming up:\n", steps);
+
+    // XOR (as in xor.cpp)
+    NeuralNetwork xorNetwork (2, 10, 1);
+    float xorInputs[4][2] = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+    float xorOutputs[4][1] = {{0}, {1}, {1}, {0}};
+    wasSuccessful &= check ("train 2-10-1", steps, [&] (size_t i) {
+        xorNetwork.train (xorInputs[i % 4], xorOutputs[i % 4]);
+    });
+
+    // deeper, with odd widths (padded rows)
+    NeuralNetwork network (std::vector<size_t> {13, 37, 21, 5});
+    std::vector<float> inputs (batch * network.m_inputCount);
+    std::vector<float> answers (batch * network.m_outputCount);
+    std::vector<float> outputs (batch * network.m_outputCount);
+    for (size_t i = 0; i < inputs.size (); ++i) {
+        inputs[i] = float (rand () % 1000) / 1000.0f;
+    }
+    for (size_t i = 0; i < answers.size (); ++i) {
+        answers[i] = float (rand () % 2);
+    }
+    const float* sample = inputs.data ();
+    const float* answer = answers.data ();
+
+    wasSuccessful &= check ("train 13-37-21-5", steps, [&] (size_t) {
+        network.train (sample, answer);
+    });
+    wasSuccessful &= check ("trainBatch 13-37-21-5", steps, [&] (size_t) {
+        network.trainBatch (sample, answer, batch);
+    });
+
+    Workspace context;
+    wasSuccessful &= check ("feedForwardInto 13-37-21-5", steps, [&] (size_t) {
+        network.feedForwardInto (sample, outputs.data (), context);
+    });
+    wasSuccessful &= check ("predictBatch 13-37-21-5", steps, [&] (size_t) {
+        network.predictBatch (sample, outputs.data (), batch, context);
+    });
+
+    Optimizer optimizer (network, OPTIMIZER_ADAM, 0.01f);
+    network.m_optimizer = &optimizer;
+    wasSuccessful &= check ("train 13-37-21-5 with Adam", steps, [&] (size_t) {
+        network.train (sample, answer);
+    });
+    wasSuccessful &= check ("trainBatch 13-37-21-5 with Adam", steps, [&] (size_t) {
+        network.trainBatch (sample, answer, batch);
+    });
+    network.m_optimizer = nullptr;
+
+    // products above the gemm threshold (128^3 multiply-adds) go through
+    // the thread pool, which starts its workers even on a single core
+    setNumThreads (4);
+    const size_t largeSteps = 20;
+    const size_t largeBatch = 256;
+    NeuralNetwork large (std::vector<size_t> {512, 512, 512, 10});
+    std::vector<float> largeInputs (largeBatch * large.m_inputCount);
+    std::vector<float> largeAnswers (largeBatch * large.m_outputCount);
+    std::vector<float> largeOutputs (largeBatch * large.m_outputCount);
+    for (size_t i = 0; i < largeInputs.size (); ++i) {
+        largeInputs[i] = float (rand () % 1000) / 1000.0f;
+    }
+    for (size_t i = 0; i < largeAnswers.size (); ++i) {
+        largeAnswers[i] = float (rand () % 2);
+    }
+
+    printf ("Allocations over %lu steps with %lu threads:\n", largeSteps, getNumThreads ());
+    wasSuccessful &= check ("trainBatch 512-512-512-10", largeSteps, [&] (size_t) {
+        large.trainBatch (largeInputs.data (), largeAnswers.data (), largeBatch);
+    });
+    wasSuccessful &= check ("predictBatch 512-512-512-10", largeSteps, [&] (size_t) {
+        large.predictBatch (largeInputs.data (), largeOutputs.data (), largeBatch, context);
+    });
+
+    printf ("Successful? ");
+    if (wasSuccessful) printf ("yes\n");
+    else printf ("no\n");
+
+    return wasSuccessful ? 0 : 1;
+
+}
+
+//========================================================================
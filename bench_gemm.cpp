@@ -0,0 +1,102 @@
+// Matrix Product Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "matrix.hpp"
+
+//========================================================================
+
+// The original textbook i-j-k loop that Matrix::product used to run
+static void naiveProduct (const Matrix& a, const Matrix& b, Matrix& product)
+{
+    for (size_t i = 0; i < a.m_rows; i++){
+        for (size_t j = 0; j < b.m_cols; j++){
+            product.m_data[i*product.m_ld+j] = 0.0f;
+            for (size_t elem = 0; elem < a.m_cols; elem++){
+                product.m_data[i*product.m_ld+j] += a.m_data[i*a.m_ld+elem] * b.m_data[elem*b.m_ld+j];
+            }
+        }
+    }
+}
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+//========================================================================
+
+int
+main (int argc, char** argv)
+{
+
+    // square sizes to run, can be overridden on the command line
+    size_t defaultSizes[] = {64, 256, 1024, 2048};
+    size_t sizeCount = sizeof(defaultSizes) / sizeof(defaultSizes[0]);
+    size_t* sizes = defaultSizes;
+    if (argc > 1) {
+        sizeCount = argc - 1;
+        sizes = new size_t[sizeCount];
+        for (size_t i = 0; i < sizeCount; ++i) {
+            sizes[i] = strtoul (argv[i+1], nullptr, 10);
+        }
+    }
+
+    // each measurement is repeated until it has run for at least this long
+    const double minSeconds = 0.5;
+
+    printf ("%8s %14s %14s %10s %12s\n", "n", "naive GFLOP/s", "gemm GFLOP/s", "speedup", "max |diff|");
+
+    for (size_t s = 0; s < sizeCount; ++s) {
+        size_t n = sizes[s];
+        double flops = 2.0 * n * n * n;
+
+        Matrix a (n, n);
+        Matrix b (n, n);
+        a.randomize ();
+        b.randomize ();
+        Matrix expected (n, n);
+
+        // naive loop
+        size_t reps = 0;
+        double start = now ();
+        double elapsed = 0.0;
+        do {
+            naiveProduct (a, b, expected);
+            ++reps;
+            elapsed = now () - start;
+        } while (elapsed < minSeconds);
+        double naiveGflops = flops * reps / elapsed * 1e-9;
+
+        // Matrix::product
+        Matrix result = Matrix::product (a, b);
+        reps = 0;
+        start = now ();
+        do {
+            Matrix::productInto (a, b, result);
+            ++reps;
+            elapsed = now () - start;
+        } while (elapsed < minSeconds);
+        double gemmGflops = flops * reps / elapsed * 1e-9;
+
+        // compare results
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                maxDiff = fmaxf (maxDiff, fabsf (result.m_data[i * result.m_ld + j] - expected.m_data[i * expected.m_ld + j]));
+            }
+        }
+
+        printf ("%8lu %14.2f %14.2f %9.1fx %12.2e\n", n, naiveGflops, gemmGflops, gemmGflops / naiveGflops, maxDiff);
+    }
+
+}
+
+//========================================================================
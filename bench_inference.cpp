@@ -0,0 +1,126 @@
+// Shared Network Inference Throughput Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "neuralnet.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+//========================================================================
+
+// Runs samples through one shared network from threads request threads
+// for about seconds, returns samples per second over all threads
+// batch 1 uses feedForwardInto, larger batches use predictBatch
+static double measure (const NeuralNetwork& nn, size_t threads, size_t batch, double seconds)
+{
+    std::atomic<bool> stop (false);
+    std::vector<size_t> samples (threads, 0);
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; ++t) {
+        workers.push_back (std::thread ([&, t] {
+            // every thread has its own inputs, outputs and context
+            std::vector<float> inputs (nn.m_inputCount * batch);
+            std::vector<float> outputs (nn.m_outputCount * batch);
+            for (size_t i = 0; i < inputs.size (); ++i) {
+                inputs[i] = float (rand () % 100) / 100.0f;
+            }
+            Workspace context;
+            size_t count = 0;
+            while (!stop.load (std::memory_order_relaxed)) {
+                if (batch == 1) {
+                    nn.feedForwardInto (inputs.data (), outputs.data (), context);
+                }
+                else {
+                    nn.predictBatch (inputs.data (), outputs.data (), batch, context);
+                }
+                count += batch;
+            }
+            samples[t] = count;
+        }));
+    }
+
+    double start = now ();
+    std::this_thread::sleep_for (std::chrono::duration<double> (seconds));
+    stop = true;
+    for (size_t t = 0; t < threads; ++t) {
+        workers[t].join ();
+    }
+    double elapsed = now () - start;
+
+    size_t total = 0;
+    for (size_t t = 0; t < threads; ++t) {
+        total += samples[t];
+    }
+    return total / elapsed;
+}
+
+//========================================================================
+
+int
+main (int argc, char** argv)
+{
+
+    // usage: bench_inference [maxThreads] [layer sizes...]
+    size_t maxThreads = std::thread::hardware_concurrency ();
+    if (argc > 1) {
+        maxThreads = strtoul (argv[1], nullptr, 10);
+    }
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+
+    std::vector<size_t> layers = {784, 256, 128, 10};
+    if (argc > 3) {
+        layers.clear ();
+        for (int i = 2; i < argc; ++i) {
+            layers.push_back (strtoul (argv[i], nullptr, 10));
+        }
+    }
+
+    // parallelism comes from the request threads only
+    // (the library's own pool would compete with them for cores)
+    setNumThreads (1);
+
+    // one network shared (read only) by every thread
+    const NeuralNetwork nn (layers);
+
+    printf ("network:");
+    for (size_t i = 0; i < layers.size (); ++i) {
+        printf (" %lu", layers[i]);
+    }
+    printf ("\n");
+
+    // each measurement runs for this long
+    const double seconds = 0.5;
+
+    size_t batches[] = {1, 64};
+    printf ("%8s %8s %14s %10s %11s\n", "batch", "threads", "samples/s", "speedup", "efficiency");
+    for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b) {
+        double base = 0.0;
+        for (size_t threads = 1; threads <= maxThreads; ++threads) {
+            double rate = measure (nn, threads, batches[b], seconds);
+            if (threads == 1) {
+                base = rate;
+            }
+            double speedup = rate / base;
+            printf ("%8lu %8lu %14.0f %9.2fx %10.0f%%\n", batches[b], threads, rate, speedup, 100.0 * speedup / threads);
+        }
+    }
+
+}
+
+//========================================================================
@@ -0,0 +1,181 @@
+// Optimizer Time-To-Target Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Trains the same initial network with each optimizer until the loss
+// (mean squared error over the dataset) reaches a target, and reports
+// the updates, epochs and wall time it took:
+// - XOR, one sample per update, as in xor.cpp
+// - a synthetic 10 class problem (clusters in 64 dimensions with noise
+//   twice their spread, one-hot answers), mini-batches of 32
+// Rates are typical starting points for each optimizer, plain SGD is
+// run at the network's default rate and at a tuned one.
+//
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "neuralnet.hpp"
+#include "optimizer.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+// Returns the mean squared error of nn over the dataset
+static double loss (const NeuralNetwork& nn, const std::vector<float>& inputs, const std::vector<float>& answers, size_t count)
+{
+    std::vector<float> outputs (answers.size ());
+    nn.predictBatch (inputs.data (), outputs.data (), count);
+    double sum = 0.0;
+    for (size_t i = 0; i < outputs.size (); ++i) {
+        double error = answers[i] - outputs[i];
+        sum += error * error;
+    }
+    return sum / outputs.size ();
+}
+
+struct Contender
+{
+    OptimizerKind m_kind;
+    float m_rate;
+    // plain network training (no optimizer attached) at m_rate
+    bool m_plain;
+};
+
+// Trains a copy of initial with contender until the loss reaches target
+// (checked every epoch of count samples) or maxEpochs, prints one row
+// returns the seconds it took (training only, not the loss checks)
+// speedups are over base seconds, a lower bound (>=) when baseMissed
+// batch 1 uses train, larger batches trainBatch
+static double run (const NeuralNetwork& initial, const Contender& contender,
+                   const std::vector<float>& inputs, const std::vector<float>& answers,
+                   size_t count, size_t batch, double target, size_t maxEpochs,
+                   double base, bool baseMissed, bool& reached)
+{
+    NeuralNetwork nn (initial);
+    Optimizer optimizer (nn, contender.m_kind, contender.m_rate);
+    if (contender.m_plain) {
+        nn.m_learning_rate = contender.m_rate;
+    }
+    else {
+        nn.m_optimizer = &optimizer;
+    }
+
+    // xor picks samples at random like xor.cpp, larger sets go in order
+    bool random = count < batch * 16;
+
+    size_t updates = 0;
+    size_t epochs = 0;
+    double seconds = 0.0;
+    double current = loss (nn, inputs, answers, count);
+    while (current > target && epochs < maxEpochs) {
+        double start = now ();
+        for (size_t s = 0; s < count; s += batch) {
+            size_t first = random ? size_t (rand () % count) : s;
+            size_t size = (count - first < batch) ? count - first : batch;
+            if (size == 1) {
+                nn.train (&inputs[first * nn.m_inputCount], &answers[first * nn.m_outputCount]);
+            }
+            else {
+                nn.trainBatch (&inputs[first * nn.m_inputCount], &answers[first * nn.m_outputCount], size);
+            }
+            ++updates;
+        }
+        seconds += now () - start;
+        ++epochs;
+        current = loss (nn, inputs, answers, count);
+    }
+
+    reached = current <= target;
+    char name[32];
+    snprintf (name, sizeof(name), "%s%s", contender.m_plain ? "plain " : "", optimizerName (contender.m_kind));
+    char speedup[32];
+    if (!reached)         snprintf (speedup, sizeof(speedup), "missed");
+    else if (base <= 0.0) snprintf (speedup, sizeof(speedup), "baseline");
+    else                  snprintf (speedup, sizeof(speedup), "%s%.1fx", baseMissed ? ">=" : "", base / seconds);
+    printf ("%-14s %8g %10lu %8lu %10.3f %10.6f %9s\n", name, contender.m_rate, updates, epochs,
+        seconds, current, speedup);
+    return seconds;
+}
+
+// Runs every contender on one problem
+static void compare (const char* title, const std::vector<size_t>& layers,
+                     const std::vector<float>& inputs, const std::vector<float>& answers,
+                     size_t count, size_t batch, double target, size_t maxEpochs,
+                     const std::vector<Contender>& contenders)
+{
+    // every run starts from the same weights
+    NeuralNetwork initial (layers);
+
+    printf ("\n%s: target loss %g, batch %lu, at most %lu epochs of %lu samples\n",
+        title, target, batch, maxEpochs, count);
+    printf ("%-14s %8s %10s %8s %10s %10s %9s\n", "optimizer", "rate", "updates", "epochs", "seconds", "loss", "speedup");
+    double base = 0.0;
+    bool baseMissed = false;
+    for (size_t c = 0; c < contenders.size (); ++c) {
+        bool reached;
+        double seconds = run (initial, contenders[c], inputs, answers, count, batch, target, maxEpochs,
+                              base, baseMissed, reached);
+        if (c == 0) {
+            base = seconds;
+            baseMissed = !reached;
+        }
+    }
+}
+
+//========================================================================
+
+int
+main ()
+{
+
+    // one core, so the comparison is of the optimizers alone
+    setNumThreads (1);
+
+    // plain SGD at the network's default rate is the baseline
+    std::vector<Contender> contenders = {
+        {OPTIMIZER_SGD,      0.1f,  true},
+        {OPTIMIZER_SGD,      1.0f,  true},
+        {OPTIMIZER_SGD,      1.0f,  false},
+        {OPTIMIZER_MOMENTUM, 0.1f,  false},
+        {OPTIMIZER_RMSPROP,  0.01f, false},
+        {OPTIMIZER_ADAM,     0.01f, false},
+    };
+
+    // XOR
+    std::vector<float> xorInputs = {0, 0, 0, 1, 1, 0, 1, 1};
+    std::vector<float> xorAnswers = {0, 1, 1, 0};
+    srand (1);
+    compare ("xor 2-10-1", {2, 10, 1}, xorInputs, xorAnswers, 4, 1, 0.001, 200000, contenders);
+
+    // clusters: a random center per class, samples are a center plus noise
+    const size_t classes = 10;
+    const size_t inputCount = 64;
+    const size_t count = 8192;
+    std::vector<float> centers (classes * inputCount);
+    for (size_t i = 0; i < centers.size (); ++i) {
+        centers[i] = float (rand () % 1000) / 1000.0f;
+    }
+    std::vector<float> inputs (count * inputCount);
+    std::vector<float> answers (count * classes, 0.0f);
+    for (size_t s = 0; s < count; ++s) {
+        size_t label = rand () % classes;
+        for (size_t i = 0; i < inputCount; ++i) {
+            float noise = 2.0f * (float (rand () % 1000) / 1000.0f - 0.5f);
+            inputs[s * inputCount + i] = centers[label * inputCount + i] + noise;
+        }
+        answers[s * classes + label] = 1.0f;
+    }
+    compare ("clusters 64-32-10", {inputCount, 32, classes}, inputs, answers, count, 32, 0.005, 300, contenders);
+
+}
+
+//========================================================================
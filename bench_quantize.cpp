@@ -0,0 +1,154 @@
+// INT8 Quantization Accuracy and Throughput Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Quantizes a network (loaded from a model file, or random with weights
+// scaled so the sigmoids are not saturated), calibrating on one set of
+// samples and comparing against the float network on another:
+// - weight memory
+// - output error and how often the largest output is the same node
+// - predictions per second, one sample and 64 samples per call
+//
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "neuralnet.hpp"
+#include "quantize.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+// Returns the index of the largest of count values
+static size_t largest (const float* values, size_t count)
+{
+    size_t best = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (values[i] > values[best]) best = i;
+    }
+    return best;
+}
+
+// Runs predict over samples (batch at a time) for about seconds
+// returns samples per second
+template <typename F>
+static double measure (F predict, size_t samples, size_t batch, double seconds)
+{
+    size_t count = 0;
+    size_t first = 0;
+    double start = now ();
+    double elapsed = 0.0;
+    while (elapsed < seconds) {
+        for (size_t i = 0; i < 64; ++i) {
+            if (first + batch > samples) first = 0;
+            predict (first, batch);
+            first += batch;
+            count += batch;
+        }
+        elapsed = now () - start;
+    }
+    return count / elapsed;
+}
+
+//========================================================================
+
+int
+main (int argc, char** argv)
+{
+
+    // usage: bench_quantize [model file]
+    NeuralNetwork* nn = nullptr;
+    if (argc > 1) {
+        nn = NeuralNetwork::loadMapped (argv[1]);
+        if (!nn) {
+            return 1;
+        }
+    }
+    else {
+        nn = new NeuralNetwork (std::vector<size_t> {784, 256, 128, 10});
+        for (size_t l = 0; l < nn->m_layers.size (); ++l) {
+            nn->m_layers[l].m_weights.multiply (4.0f / sqrtf (float (nn->m_layerSizes[l])));
+        }
+    }
+
+    // single threaded, both networks are compared on one core
+    setNumThreads (1);
+
+    const size_t calibrationCount = 1000;
+    const size_t testCount = 10000;
+    size_t inputCount = nn->m_inputCount;
+    size_t outputCount = nn->m_outputCount;
+
+    std::vector<float> calibration (calibrationCount * inputCount);
+    std::vector<float> inputs (testCount * inputCount);
+    for (size_t i = 0; i < calibration.size (); ++i) {
+        calibration[i] = float (rand () % 256) / 255.0f;
+    }
+    for (size_t i = 0; i < inputs.size (); ++i) {
+        inputs[i] = float (rand () % 256) / 255.0f;
+    }
+
+    QuantizedNetwork qnn (*nn, calibration.data (), calibrationCount);
+
+    printf ("network:");
+    for (size_t i = 0; i < nn->m_layerSizes.size (); ++i) {
+        printf (" %lu", nn->m_layerSizes[i]);
+    }
+    printf ("  int8 kernels: %s\n", int8LevelName (int8Level ()));
+
+    // memory
+    size_t floatBytes = 0;
+    for (size_t l = 0; l < nn->m_layers.size (); ++l) {
+        floatBytes += (nn->m_layerSizes[l] + 1) * nn->m_layerSizes[l + 1] * sizeof(float);
+    }
+    printf ("weights: float %lu bytes, int8 %lu bytes (%.2fx smaller)\n",
+        floatBytes, qnn.weightBytes (), double (floatBytes) / qnn.weightBytes ());
+
+    // accuracy on samples the calibration did not see
+    std::vector<float> expected (testCount * outputCount);
+    std::vector<float> actual (testCount * outputCount);
+    nn->predictBatch (inputs.data (), expected.data (), testCount);
+    qnn.predictBatch (inputs.data (), actual.data (), testCount);
+    double maxError = 0.0;
+    double sumError = 0.0;
+    size_t agree = 0;
+    for (size_t s = 0; s < testCount; ++s) {
+        for (size_t i = 0; i < outputCount; ++i) {
+            double error = fabs (expected[s * outputCount + i] - actual[s * outputCount + i]);
+            maxError = (error > maxError) ? error : maxError;
+            sumError += error;
+        }
+        agree += largest (&expected[s * outputCount], outputCount) == largest (&actual[s * outputCount], outputCount);
+    }
+    printf ("accuracy over %lu samples: max abs error %.6f, mean abs error %.6f, same largest output %.2f%%\n",
+        testCount, maxError, sumError / (testCount * outputCount), 100.0 * agree / testCount);
+
+    // throughput
+    const double seconds = 0.5;
+    printf ("%8s %14s %14s %10s\n", "batch", "float/s", "int8/s", "speedup");
+    size_t batches[] = {1, 64};
+    for (size_t b = 0; b < 2; ++b) {
+        size_t batch = batches[b];
+        double floatRate = measure ([&] (size_t first, size_t count) {
+            nn->predictBatch (&inputs[first * inputCount], &expected[first * outputCount], count);
+        }, testCount, batch, seconds);
+        double int8Rate = measure ([&] (size_t first, size_t count) {
+            qnn.predictBatch (&inputs[first * inputCount], &actual[first * outputCount], count);
+        }, testCount, batch, seconds);
+        printf ("%8lu %14.0f %14.0f %9.2fx\n", batch, floatRate, int8Rate, int8Rate / floatRate);
+    }
+
+    delete nn;
+
+}
+
+//========================================================================
@@ -0,0 +1,115 @@
+// Sparse Input Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Trains and runs a 10000-128-10 network on samples with 1% to 10% of
+// their inputs nonzero, once from dense arrays and once from the same
+// samples as a SparseMatrix, and reports samples per second of each:
+// - trainBatch, batches of 64
+// - predictBatch
+// The dense time does not depend on the sparsity, the sparse time grows
+// with the nonzeros.
+//
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "neuralnet.hpp"
+#include "sparse.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+// Returns the samples per second of op (run until at least half a second
+// has passed), op processes count samples
+template <typename Op>
+static double rate (size_t count, Op op)
+{
+    op ();
+    size_t runs = 0;
+    double start = now ();
+    double elapsed = 0.0;
+    while (elapsed < 0.5) {
+        op ();
+        ++runs;
+        elapsed = now () - start;
+    }
+    return runs * count / elapsed;
+}
+
+//========================================================================
+
+int
+main ()
+{
+
+    // one core, so the comparison is of the kernels alone
+    setNumThreads (1);
+
+    const size_t inputCount = 10000;
+    const size_t outputCount = 10;
+    const size_t count = 1024;
+    const size_t batch = 64;
+
+    printf ("%lu-128-%lu network, %lu samples, batch %lu\n", inputCount, outputCount, count, batch);
+    printf ("%8s %10s %14s %14s %8s %14s %14s %8s\n", "nonzero", "per sample",
+        "dense train/s", "sparse train/s", "speedup", "dense pred/s", "sparse pred/s", "speedup");
+
+    const double densities[] = {0.01, 0.02, 0.05, 0.10};
+    for (double density : densities) {
+        srand (1);
+        std::vector<float> inputs (count * inputCount, 0.0f);
+        std::vector<float> answers (count * outputCount, 0.0f);
+        for (size_t s = 0; s < count; ++s) {
+            for (size_t i = 0; i < inputCount; ++i) {
+                if (rand () < density * RAND_MAX) {
+                    inputs[s * inputCount + i] = 1.0f;
+                }
+            }
+            answers[s * outputCount + rand () % outputCount] = 1.0f;
+        }
+        SparseMatrix sparse = SparseMatrix::fromDense (inputs.data (), count, inputCount);
+
+        // the sparse batches, built once
+        std::vector<SparseMatrix> batches;
+        for (size_t first = 0; first < count; first += batch) {
+            batches.push_back (SparseMatrix::fromDense (&inputs[first * inputCount], batch, inputCount));
+        }
+
+        NeuralNetwork denseNet (inputCount, 128, outputCount);
+        NeuralNetwork sparseNet (denseNet);
+        std::vector<float> outputs (count * outputCount);
+
+        double denseTrain = rate (count, [&] () {
+            for (size_t first = 0; first < count; first += batch) {
+                denseNet.trainBatch (&inputs[first * inputCount], &answers[first * outputCount], batch);
+            }
+        });
+        double sparseTrain = rate (count, [&] () {
+            for (size_t b = 0; b < batches.size (); ++b) {
+                sparseNet.trainBatch (batches[b], &answers[b * batch * outputCount]);
+            }
+        });
+        double densePredict = rate (count, [&] () {
+            denseNet.predictBatch (inputs.data (), outputs.data (), count);
+        });
+        double sparsePredict = rate (count, [&] () {
+            sparseNet.predictBatch (sparse, outputs.data ());
+        });
+
+        printf ("%7.0f%% %10.0f %14.0f %14.0f %7.1fx %14.0f %14.0f %7.1fx\n", density * 100.0,
+            double (sparse.nonZeros ()) / count, denseTrain, sparseTrain, sparseTrain / denseTrain,
+            densePredict, sparsePredict, sparsePredict / densePredict);
+    }
+
+}
+
+//========================================================================
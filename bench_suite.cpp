@@ -0,0 +1,343 @@
+// Benchmark Suite
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Micro and macro benchmarks with machine readable results, for
+// tracking performance between releases (make bench):
+//
+//   matrix    product over several shapes, copy, elementwise add /
+//             subtract / multiply / scalar add, transpose and map
+//   network   feedForward latency, train and trainBatch throughput and
+//             the time of a full epoch, for several network sizes
+//
+// Every benchmark is run warm-up times untimed, then timed repetitions
+// times. Each repetition runs the operation enough times to take at
+// least ~1 ms and records the time per operation (latency benchmarks
+// instead time 50 x repetitions single calls, for the percentiles).
+// Results report the mean, standard deviation, min, median, p90, p99
+// and max over the repetitions, plus a throughput where one makes sense.
+//
+// usage: bench_suite [--format csv|json] [--output file]
+//                    [--reps n] [--warmup n] [--filter text]
+//
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "matrix.hpp"
+#include "matrix_expr.hpp"
+#include "neuralnet.hpp"
+#include "profile.hpp"
+#include "simd.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+// each timed repetition runs for at least this long (unless it is a
+// latency benchmark)
+static const double MIN_REPETITION_SECONDS = 1e-3;
+
+struct Options
+{
+    bool json = false;
+    const char* output = nullptr;
+    size_t reps = 20;
+    size_t warmup = 3;
+    const char* filter = nullptr;
+};
+
+struct Result
+{
+    std::string group;
+    std::string name;
+    std::string params;
+    size_t reps;
+    // seconds per operation
+    double mean, stddev, min, median, p90, p99, max;
+    // units of work per second at the mean (0 if none)
+    double throughput;
+    const char* unit;
+};
+
+//========================================================================
+
+// Returns the p-th percentile (0..1) of sorted values (nearest rank)
+static double percentile (const std::vector<double>& sorted, double p)
+{
+    size_t rank = (size_t) ceil (p * sorted.size ());
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+// Runs one benchmark and appends its result
+// - op runs the operation once
+// - work is the units of work one operation does (e.g. flops) and unit
+//   their name per second, work 0 reports no throughput
+// - latency times every call on its own (reps calls) instead of
+//   batching calls into ~1 ms repetitions
+static void run (const Options& options, std::vector<Result>& results,
+                 const char* group, const char* name, const std::string& params,
+                 const std::function<void()>& op, double work, const char* unit, bool latency = false)
+{
+    std::string full = std::string (group) + "/" + name + "/" + params;
+    if (options.filter && !strstr (full.c_str (), options.filter)) {
+        return;
+    }
+
+    for (size_t i = 0; i < options.warmup; ++i) {
+        op ();
+    }
+
+    // calls per repetition
+    size_t calls = 1;
+    if (!latency) {
+        double start = now ();
+        op ();
+        double once = now () - start;
+        if (once < MIN_REPETITION_SECONDS) {
+            calls = (size_t) (MIN_REPETITION_SECONDS / (once > 1e-9 ? once : 1e-9)) + 1;
+        }
+    }
+
+    size_t reps = latency ? options.reps * 50 : options.reps;
+    std::vector<double> times (reps);
+    for (size_t r = 0; r < reps; ++r) {
+        double start = now ();
+        for (size_t c = 0; c < calls; ++c) {
+            op ();
+        }
+        times[r] = (now () - start) / calls;
+    }
+
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.params = params;
+    result.reps = reps;
+
+    double sum = 0.0;
+    for (size_t r = 0; r < reps; ++r) sum += times[r];
+    result.mean = sum / reps;
+    double squares = 0.0;
+    for (size_t r = 0; r < reps; ++r) squares += (times[r] - result.mean) * (times[r] - result.mean);
+    result.stddev = (reps > 1) ? sqrt (squares / (reps - 1)) : 0.0;
+
+    std::sort (times.begin (), times.end ());
+    result.min = times.front ();
+    result.median = percentile (times, 0.5);
+    result.p90 = percentile (times, 0.9);
+    result.p99 = percentile (times, 0.99);
+    result.max = times.back ();
+    result.throughput = (work > 0.0) ? work / result.mean : 0.0;
+    result.unit = unit;
+    results.push_back (result);
+
+    // progress on stderr (results may be going to stdout)
+    fprintf (stderr, "%-44s %12.3f us %12.3g %s\n", full.c_str (), result.mean * 1e6, result.throughput, unit);
+}
+
+//========================================================================
+// BENCHMARKS
+
+static void matrixBenchmarks (const Options& options, std::vector<Result>& results)
+{
+    // product: square, and the shapes a network's layers produce
+    // (weights x batch of inputs), m x k times k x n
+    size_t shapes[][3] = {
+        {64, 64, 64}, {256, 256, 256}, {512, 512, 512},
+        {128, 784, 1}, {128, 784, 64}, {10, 128, 64}, {1024, 64, 1024}
+    };
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s) {
+        size_t m = shapes[s][0], k = shapes[s][1], n = shapes[s][2];
+        Matrix a (m, k), b (k, n), c (m, n);
+        a.randomize ();
+        b.randomize ();
+        char params[64];
+        snprintf (params, sizeof(params), "%lux%lux%lu", m, k, n);
+        run (options, results, "matrix", "product", params,
+             [&] { Matrix::productInto (a, b, c); }, 2.0 * m * k * n, "flop/s");
+    }
+
+    // elementwise over a million elements
+    // each starts from a copy of x (so values stay in range), copy is
+    // timed on its own to subtract
+    size_t n = 1 << 20;
+    Matrix x (1024, n / 1024), y (1024, n / 1024), z (1024, n / 1024);
+    x.randomize ();
+    y.randomize ();
+    std::string params = std::to_string (1024) + "x" + std::to_string (n / 1024);
+    run (options, results, "matrix", "copy", params, [&] { z = x; }, n, "elements/s");
+    run (options, results, "matrix", "add", params, [&] { z = x; z.add (y); }, n, "elements/s");
+    run (options, results, "matrix", "subtract", params, [&] { z = x; z.subtract (y); }, n, "elements/s");
+    run (options, results, "matrix", "multiply", params, [&] { z = x; z.multiply (y); }, n, "elements/s");
+    run (options, results, "matrix", "add_scalar", params, [&] { z = x; z.add (0.5f); }, n, "elements/s");
+    run (options, results, "matrix", "expression", params, [&] { z = x * y + x; }, n, "elements/s");
+    run (options, results, "matrix", "map", params,
+         [&] { z = x; z.map ([] (float v) { return v * v + 1.0f; }); }, n, "elements/s");
+
+    size_t sizes[] = {256, 1024};
+    for (size_t s = 0; s < 2; ++s) {
+        Matrix t (sizes[s], sizes[s]);
+        t.randomize ();
+        std::string square = std::to_string (sizes[s]) + "x" + std::to_string (sizes[s]);
+        run (options, results, "matrix", "transpose", square,
+             [&] { Matrix result = Matrix::transpose (t); }, double (sizes[s]) * sizes[s], "elements/s");
+    }
+}
+
+static void networkBenchmarks (const Options& options, std::vector<Result>& results)
+{
+    std::vector<std::vector<size_t> > networks = {
+        {2, 4, 1}, {64, 32, 10}, {784, 128, 10}, {784, 256, 128, 10}
+    };
+    const size_t epochSamples = 4096;
+    const size_t batch = 64;
+
+    for (size_t i = 0; i < networks.size (); ++i) {
+        NeuralNetwork nn (networks[i]);
+        std::string params;
+        for (size_t l = 0; l < networks[i].size (); ++l) {
+            params += (l ? "-" : "") + std::to_string (networks[i][l]);
+        }
+
+        std::vector<float> inputs (epochSamples * nn.m_inputCount);
+        std::vector<float> answers (epochSamples * nn.m_outputCount);
+        std::vector<float> outputs (batch * nn.m_outputCount);
+        for (size_t v = 0; v < inputs.size (); ++v) inputs[v] = float (rand () % 100) / 100.0f;
+        for (size_t v = 0; v < answers.size (); ++v) answers[v] = float (rand () % 2);
+
+        run (options, results, "network", "feedforward_latency", params,
+             [&] { nn.feedForwardInto (inputs.data (), outputs.data ()); }, 1, "samples/s", true);
+        run (options, results, "network", "predict_batch", params + "/b" + std::to_string (batch),
+             [&] { nn.predictBatch (inputs.data (), outputs.data (), batch); }, batch, "samples/s");
+
+        size_t sample = 0;
+        run (options, results, "network", "train", params,
+             [&] {
+                 nn.train (&inputs[sample * nn.m_inputCount], &answers[sample * nn.m_outputCount]);
+                 sample = (sample + 1) % epochSamples;
+             }, 1, "samples/s");
+        run (options, results, "network", "train_batch", params + "/b" + std::to_string (batch),
+             [&] {
+                 nn.trainBatch (&inputs[sample * nn.m_inputCount], &answers[sample * nn.m_outputCount], batch);
+                 sample = (sample + batch) % epochSamples;
+             }, batch, "samples/s");
+
+        run (options, results, "network", "epoch", params + "/n" + std::to_string (epochSamples) + "/b" + std::to_string (batch),
+             [&] {
+                 for (size_t s = 0; s < epochSamples; s += batch) {
+                     nn.trainBatch (&inputs[s * nn.m_inputCount], &answers[s * nn.m_outputCount], batch);
+                 }
+             }, epochSamples, "samples/s");
+    }
+}
+
+//========================================================================
+// OUTPUT
+
+static void writeCsv (FILE* out, const std::vector<Result>& results)
+{
+    fprintf (out, "group,name,params,reps,mean_s,stddev_s,min_s,median_s,p90_s,p99_s,max_s,throughput,unit\n");
+    for (size_t i = 0; i < results.size (); ++i) {
+        const Result& r = results[i];
+        fprintf (out, "%s,%s,%s,%lu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%s\n",
+            r.group.c_str (), r.name.c_str (), r.params.c_str (), r.reps,
+            r.mean, r.stddev, r.min, r.median, r.p90, r.p99, r.max, r.throughput, r.unit);
+    }
+}
+
+static void writeJson (FILE* out, const Options& options, const std::vector<Result>& results)
+{
+    fprintf (out, "{\n");
+    fprintf (out, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf (out, "  \"simd\": \"%s\",\n", simdLevelName (simd ().level));
+    fprintf (out, "  \"threads\": %lu,\n", getNumThreads ());
+    fprintf (out, "  \"warmup\": %lu,\n", options.warmup);
+    fprintf (out, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size (); ++i) {
+        const Result& r = results[i];
+        fprintf (out, "    {\"group\": \"%s\", \"name\": \"%s\", \"params\": \"%s\", \"reps\": %lu, "
+                      "\"mean_s\": %.9g, \"stddev_s\": %.9g, \"min_s\": %.9g, \"median_s\": %.9g, "
+                      "\"p90_s\": %.9g, \"p99_s\": %.9g, \"max_s\": %.9g, \"throughput\": %.9g, \"unit\": \"%s\"}%s\n",
+            r.group.c_str (), r.name.c_str (), r.params.c_str (), r.reps,
+            r.mean, r.stddev, r.min, r.median, r.p90, r.p99, r.max, r.throughput, r.unit,
+            (i + 1 < results.size ()) ? "," : "");
+    }
+    fprintf (out, "  ]\n}\n");
+}
+
+//========================================================================
+
+int
+main (int argc, char** argv)
+{
+
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp (argv[i], "--format") == 0 && hasValue) {
+            options.json = strcmp (argv[++i], "json") == 0;
+        }
+        else if (strcmp (argv[i], "--output") == 0 && hasValue) {
+            options.output = argv[++i];
+        }
+        else if (strcmp (argv[i], "--reps") == 0 && hasValue) {
+            options.reps = strtoul (argv[++i], nullptr, 10);
+        }
+        else if (strcmp (argv[i], "--warmup") == 0 && hasValue) {
+            options.warmup = strtoul (argv[++i], nullptr, 10);
+        }
+        else if (strcmp (argv[i], "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        }
+        else {
+            printf ("usage: %s [--format csv|json] [--output file] [--reps n] [--warmup n] [--filter text]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.reps == 0) {
+        options.reps = 1;
+    }
+
+    std::vector<Result> results;
+    matrixBenchmarks (options, results);
+    networkBenchmarks (options, results);
+
+    FILE* out = stdout;
+    if (options.output) {
+        out = fopen (options.output, "w");
+        if (!out) {
+            printf ("error: could not open %s for writing\n", options.output);
+            return 1;
+        }
+    }
+    if (options.json) {
+        writeJson (out, options, results);
+    }
+    else {
+        writeCsv (out, results);
+    }
+    if (out != stdout) {
+        fclose (out);
+    }
+
+    // where the network benchmarks spent their time (NN_PROFILE builds)
+    if (profileEnabled ()) {
+        profileDump (stderr);
+    }
+
+}
+
+//========================================================================
@@ -0,0 +1,88 @@
+// Matrix Product Thread Scaling Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include "matrix.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+//========================================================================
+
+int
+main (int argc, char** argv)
+{
+
+    // usage: bench_threads [maxThreads] [sizes...]
+    size_t maxThreads = std::thread::hardware_concurrency ();
+    if (argc > 1) {
+        maxThreads = strtoul (argv[1], nullptr, 10);
+    }
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+
+    size_t defaultSizes[] = {512, 1024, 2048};
+    size_t sizeCount = sizeof(defaultSizes) / sizeof(defaultSizes[0]);
+    size_t* sizes = defaultSizes;
+    if (argc > 2) {
+        sizeCount = argc - 2;
+        sizes = new size_t[sizeCount];
+        for (size_t i = 0; i < sizeCount; ++i) {
+            sizes[i] = strtoul (argv[i+2], nullptr, 10);
+        }
+    }
+
+    // each measurement is repeated until it has run for at least this long
+    const double minSeconds = 0.5;
+
+    printf ("%8s %8s %10s %10s %11s\n", "n", "threads", "GFLOP/s", "speedup", "efficiency");
+
+    for (size_t s = 0; s < sizeCount; ++s) {
+        size_t n = sizes[s];
+        double flops = 2.0 * n * n * n;
+
+        Matrix a (n, n);
+        Matrix b (n, n);
+        a.randomize ();
+        b.randomize ();
+        Matrix result;
+
+        double baseGflops = 0.0;
+        for (size_t threads = 1; threads <= maxThreads; ++threads) {
+            setNumThreads (threads);
+
+            // warm up (spins up workers, grows packing buffers)
+            Matrix::productInto (a, b, result);
+
+            size_t reps = 0;
+            double start = now ();
+            double elapsed = 0.0;
+            do {
+                Matrix::productInto (a, b, result);
+                ++reps;
+                elapsed = now () - start;
+            } while (elapsed < minSeconds);
+
+            double gflops = flops * reps / elapsed * 1e-9;
+            if (threads == 1) {
+                baseGflops = gflops;
+            }
+            double speedup = gflops / baseGflops;
+            printf ("%8lu %8lu %10.2f %9.2fx %10.0f%%\n", n, threads, gflops, speedup, 100.0 * speedup / threads);
+        }
+    }
+
+}
+
+//========================================================================
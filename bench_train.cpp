@@ -0,0 +1,151 @@
+// Data-Parallel Training Benchmark
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Trains a network to imitate a fixed random "teacher" network of the
+// same shape on a synthetic dataset, single-threaded (trainBatch) and
+// with ParallelTrainer in both modes, and reports throughput and the
+// loss (mean squared error over the dataset) reached.
+//
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "neuralnet.hpp"
+#include "threadpool.hpp"
+#include "trainer.hpp"
+
+//========================================================================
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+//========================================================================
+
+// Returns the mean squared error of nn over the dataset
+static double loss (const NeuralNetwork& nn, const std::vector<float>& inputs, const std::vector<float>& answers, size_t count)
+{
+    std::vector<float> outputs (answers.size ());
+    nn.predictBatch (inputs.data (), outputs.data (), count);
+    double sum = 0.0;
+    for (size_t i = 0; i < outputs.size (); ++i) {
+        double error = answers[i] - outputs[i];
+        sum += error * error;
+    }
+    return sum / outputs.size ();
+}
+
+// Trains a copy of initial for epochs epochs and prints one result row
+// threads 0 means single-threaded trainBatch (the baseline)
+// returns samples per second
+static double run (const NeuralNetwork& initial, TrainingMode mode, size_t threads,
+                   const std::vector<float>& inputs, const std::vector<float>& answers,
+                   size_t count, size_t batch, size_t epochs, double base)
+{
+    NeuralNetwork nn (initial);
+    setNumThreads (threads == 0 ? 1 : threads);
+
+    ParallelTrainer* trainer = nullptr;
+    if (threads > 0) {
+        trainer = new ParallelTrainer (nn, mode, threads);
+    }
+
+    double first = 0.0;
+    double seconds = 0.0;
+    for (size_t e = 0; e < epochs; ++e) {
+        double start = now ();
+        if (trainer) {
+            trainer->trainEpoch (inputs.data (), answers.data (), count, batch);
+        }
+        else {
+            for (size_t s = 0; s < count; s += batch) {
+                size_t size = (count - s < batch) ? count - s : batch;
+                nn.trainBatch (&inputs[s * nn.m_inputCount], &answers[s * nn.m_outputCount], size);
+            }
+        }
+        seconds += now () - start;
+        if (e == 0) {
+            first = loss (nn, inputs, answers, count);
+        }
+    }
+    delete trainer;
+
+    double rate = count * epochs / seconds;
+    printf ("%8s %8lu %14.0f %9.2fx %12.6f %12.6f\n",
+        threads == 0 ? "single" : trainingModeName (mode), threads == 0 ? 1 : threads,
+        rate, base > 0.0 ? rate / base : 1.0, first, loss (nn, inputs, answers, count));
+    return rate;
+}
+
+//========================================================================
+
+int
+main (int argc, char** argv)
+{
+
+    // usage: bench_train [maxThreads] [epochs] [layer sizes...]
+    size_t maxThreads = std::thread::hardware_concurrency ();
+    if (argc > 1) {
+        maxThreads = strtoul (argv[1], nullptr, 10);
+    }
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+
+    size_t epochs = 10;
+    if (argc > 2) {
+        epochs = strtoul (argv[2], nullptr, 10);
+    }
+    if (epochs == 0) {
+        epochs = 1;
+    }
+
+    std::vector<size_t> layers = {64, 128, 10};
+    if (argc > 4) {
+        layers.clear ();
+        for (int i = 3; i < argc; ++i) {
+            layers.push_back (strtoul (argv[i], nullptr, 10));
+        }
+    }
+
+    const size_t count = 16384;
+    const size_t batch = 64;
+
+    // synthetic dataset: random inputs labelled by a random teacher
+    NeuralNetwork teacher (layers);
+    std::vector<float> inputs (count * teacher.m_inputCount);
+    std::vector<float> answers (count * teacher.m_outputCount);
+    for (size_t i = 0; i < inputs.size (); ++i) {
+        inputs[i] = float (rand () % 100) / 100.0f;
+    }
+    teacher.predictBatch (inputs.data (), answers.data (), count);
+
+    // every run starts from the same weights
+    NeuralNetwork initial (layers);
+    initial.m_learning_rate = 1.0;
+
+    printf ("network:");
+    for (size_t i = 0; i < layers.size (); ++i) {
+        printf (" %lu", layers[i]);
+    }
+    printf ("  samples: %lu  batch: %lu  epochs: %lu\n", count, batch, epochs);
+    printf ("initial loss: %.6f\n", loss (initial, inputs, answers, count));
+
+    printf ("%8s %8s %14s %10s %12s %12s\n", "mode", "threads", "samples/s", "speedup", "loss@1", "loss@end");
+    double base = run (initial, TRAIN_SYNC, 0, inputs, answers, count, batch, epochs, 0.0);
+    TrainingMode modes[] = {TRAIN_SYNC, TRAIN_HOGWILD};
+    for (size_t m = 0; m < 2; ++m) {
+        for (size_t threads = 1; threads <= maxThreads; ++threads) {
+            run (initial, modes[m], threads, inputs, answers, count, batch, epochs, base);
+        }
+    }
+
+}
+
+//========================================================================
@@ -0,0 +1,443 @@
+// Streaming Dataset Reader
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include "dataset.hpp"
+
+//========================================================================
+
+// the file is read through a buffer of this many bytes
+static const size_t READ_BUFFER_BYTES = 1 << 20;
+
+static double now ()
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+// Parses a decimal number ([+-]digits[.digits][e[+-]digits]) like strtof
+// plain decimals whose digits fit in 53 bits with small exponents are
+// computed directly: one multiply or divide by an exact power of ten in
+// double rounds the exact value once, and rounding that to float gives
+// strtof's result unless it landed exactly halfway between two floats.
+// Those halfway cases and anything else (longer, inf, nan, hex) go to
+// strtof, so the result always matches strtof bit for bit.
+static float parseFloat (const char* text, char** end)
+{
+    static const double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* p = text;
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+') ++p;
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    const char* start = p;
+    for (; *p >= '0' && *p <= '9'; ++p, ++digits) {
+        mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (*p == '.') {
+        for (++p; *p >= '0' && *p <= '9'; ++p, ++digits) {
+            mantissa = mantissa * 10 + (*p - '0');
+            --exponent;
+        }
+    }
+    if (p == start || (p == start + 1 && *start == '.') || digits > 18) {
+        return strtof (text, end);
+    }
+    if (*p == 'e' || *p == 'E') {
+        const char* q = p + 1;
+        bool negativeExponent = (*q == '-');
+        if (*q == '-' || *q == '+') ++q;
+        if (*q < '0' || *q > '9') {
+            return strtof (text, end);
+        }
+        int value = 0;
+        for (; *q >= '0' && *q <= '9' && value < 1000; ++q) {
+            value = value * 10 + (*q - '0');
+        }
+        exponent += negativeExponent ? -value : value;
+        p = q;
+    }
+    if (mantissa > (uint64_t (1) << 53) || exponent < -22 || exponent > 22 || *p == 'x' || *p == 'X') {
+        return strtof (text, end);
+    }
+
+    double value = double (mantissa);
+    value = (exponent < 0) ? value / powers[-exponent] : value * powers[exponent];
+    // halfway between two floats: the low 29 of the 52 mantissa bits
+    // are exactly one half of a float's last place
+    uint64_t bits;
+    memcpy (&bits, &value, sizeof(bits));
+    if ((bits & ((uint64_t (1) << 29) - 1)) == (uint64_t (1) << 28)) {
+        return strtof (text, end);
+    }
+    *end = (char*) p;
+    return float (negative ? -value : value);
+}
+
+//========================================================================
+
+// Opens a dataset and starts reading the first pass
+DatasetReader::DatasetReader (const char* path, size_t inputCount, size_t outputCount,
+                              size_t batchSize, size_t shuffleWindow, unsigned seed)
+    : m_inputCount (inputCount),
+      m_outputCount (outputCount),
+      m_batchSize (batchSize),
+      m_shuffleWindow (shuffleWindow),
+      m_seed (seed),
+      m_file (nullptr),
+      m_binary (false),
+      m_dataStart (0),
+      m_recordCount (0),
+      m_remaining (0),
+      m_produced (0),
+      m_taken (0),
+      m_released (0),
+      m_pass (0),
+      m_passPending (false),
+      // nothing to wait for until the file is open
+      m_passDone (true),
+      m_abort (false),
+      m_stop (false),
+      m_waitSeconds (0.0)
+{
+    m_counts[0] = 0;
+    m_counts[1] = 0;
+
+    // Ensure params are valid
+    if (!path || batchSize == 0 || inputCount + outputCount == 0) {
+        printf ("error: please enter a valid path, batch size and sample size\n");
+        return;
+    }
+
+    FILE* file = fopen (path, "rb");
+    if (!file) {
+        printf ("error: could not open %s\n", path);
+        return;
+    }
+    setvbuf (file, nullptr, _IOFBF, READ_BUFFER_BYTES);
+
+    // binary datasets start with the magic, anything else is CSV
+    DatasetHeader header;
+    if (fread (&header, sizeof(header), 1, file) == 1
+        && memcmp (header.m_magic, DATASET_MAGIC, sizeof(header.m_magic)) == 0) {
+        if (header.m_inputCount != inputCount || header.m_outputCount != outputCount) {
+            printf ("error: %s has samples of %u inputs and %u outputs, expected %lu and %lu\n",
+                path, header.m_inputCount, header.m_outputCount, inputCount, outputCount);
+            fclose (file);
+            return;
+        }
+        fseek (file, 0, SEEK_END);
+        uint64_t bytes = ftell (file) - sizeof(header);
+        if (bytes / ((inputCount + outputCount) * sizeof(float)) < header.m_recordCount) {
+            printf ("error: %s is truncated\n", path);
+            fclose (file);
+            return;
+        }
+        m_binary = true;
+        m_dataStart = sizeof(header);
+        m_recordCount = header.m_recordCount;
+    }
+    m_file = file;
+
+    size_t width = inputCount + outputCount;
+    for (size_t b = 0; b < 2; ++b) {
+        m_buffers[b] = Workspace (Workspace::footprint (batchSize * inputCount)
+                                + Workspace::footprint (batchSize * outputCount));
+    }
+    m_window.resize (shuffleWindow * width);
+
+    m_passDone = false;
+    m_passPending = true;
+    m_thread = std::thread (&DatasetReader::run, this);
+}
+
+// stops the background thread and closes the file
+DatasetReader::~DatasetReader ()
+{
+    if (m_thread.joinable ()) {
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_stop = true;
+        }
+        m_changed.notify_all ();
+        m_thread.join ();
+    }
+    if (m_file) {
+        fclose (m_file);
+    }
+}
+
+// Returns true if the file was opened
+bool DatasetReader::isOpen () const
+{
+    return m_file != nullptr;
+}
+
+//========================================================================
+
+// Hands out the next batch of this pass
+bool DatasetReader::next (DatasetBatch& batch)
+{
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+    // the previous batch is free to be refilled
+    m_released = m_taken;
+    m_changed.notify_all ();
+
+    if (m_produced == m_taken && !m_passDone) {
+        double start = now ();
+        m_changed.wait (lock, [this] { return m_produced > m_taken || m_passDone; });
+        m_waitSeconds += now () - start;
+    }
+    if (m_produced == m_taken) {
+        return false;
+    }
+
+    size_t b = m_taken % 2;
+    batch.m_inputs = m_buffers[b].m_data;
+    batch.m_answers = m_buffers[b].m_data + Workspace::footprint (m_batchSize * m_inputCount);
+    batch.m_count = m_counts[b];
+    ++m_taken;
+    return true;
+}
+
+// Starts another pass over the file from the beginning
+void DatasetReader::rewind ()
+{
+    if (!isOpen ()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+    // end the current pass (the reader may be waiting for a buffer)
+    m_abort = true;
+    m_released = m_taken;
+    m_changed.notify_all ();
+    m_changed.wait (lock, [this] { return m_passDone; });
+
+    m_produced = 0;
+    m_taken = 0;
+    m_released = 0;
+    m_passDone = false;
+    m_abort = false;
+    ++m_pass;
+    m_passPending = true;
+    m_changed.notify_all ();
+}
+
+// Returns how long next() has waited for batches so far
+double DatasetReader::waitSeconds () const
+{
+    std::lock_guard<std::mutex> lock (m_mutex);
+    return m_waitSeconds;
+}
+
+//========================================================================
+// BACKGROUND THREAD
+
+// Runs a pass whenever one is requested
+void DatasetReader::run ()
+{
+    for (;;) {
+        size_t pass;
+        {
+            std::unique_lock<std::mutex> lock (m_mutex);
+            m_changed.wait (lock, [this] { return m_stop || m_passPending; });
+            if (m_stop) {
+                return;
+            }
+            m_passPending = false;
+            pass = m_pass;
+        }
+
+        readPass (pass);
+
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_passDone = true;
+        }
+        m_changed.notify_all ();
+    }
+}
+
+// Reads one pass into batches
+void DatasetReader::readPass (size_t pass)
+{
+    fseek (m_file, m_dataStart, SEEK_SET);
+    clearerr (m_file);
+    m_remaining = m_recordCount;
+
+    size_t width = m_inputCount + m_outputCount;
+    std::vector<float> record (width);
+    char* line = nullptr;
+    size_t lineSize = 0;
+    size_t lineNumber = 0;
+
+    // the batch being filled
+    size_t index = 0;
+    size_t filled = 0;
+    float* inputs = nullptr;
+    float* answers = nullptr;
+
+    // Appends a record to the batch, publishing it when full
+    // returns false if the pass should end
+    auto emit = [&] (const float* values) {
+        if (filled == 0) {
+            if (!waitForBuffer (index)) {
+                return false;
+            }
+            inputs = m_buffers[index % 2].m_data;
+            answers = inputs + Workspace::footprint (m_batchSize * m_inputCount);
+        }
+        memcpy (inputs + filled * m_inputCount, values, m_inputCount * sizeof(float));
+        memcpy (answers + filled * m_outputCount, values + m_inputCount, m_outputCount * sizeof(float));
+        if (++filled == m_batchSize) {
+            publish (index++, filled);
+            filled = 0;
+        }
+        return true;
+    };
+
+    bool going = true;
+    if (m_shuffleWindow == 0) {
+        // file order
+        while (going && readRecord (record.data (), line, lineSize, lineNumber)) {
+            going = emit (record.data ());
+        }
+    }
+    else {
+        // fill the window, then draw at random, refilling the drawn place
+        std::mt19937 random (m_seed + pass);
+        size_t windowed = 0;
+        while (windowed < m_shuffleWindow && readRecord (&m_window[windowed * width], line, lineSize, lineNumber)) {
+            ++windowed;
+        }
+        while (going && windowed > 0) {
+            float* drawn = &m_window[(random () % windowed) * width];
+            going = emit (drawn);
+            if (going && !readRecord (drawn, line, lineSize, lineNumber)) {
+                // the file is used up, the last record takes the place
+                --windowed;
+                memmove (drawn, &m_window[windowed * width], width * sizeof(float));
+            }
+        }
+    }
+
+    // the last batch of the pass may be short
+    if (going && filled > 0) {
+        publish (index, filled);
+    }
+    free (line);
+}
+
+// Reads the next record (inputs then answers)
+bool DatasetReader::readRecord (float* values, char*& line, size_t& lineSize, size_t& lineNumber)
+{
+    size_t width = m_inputCount + m_outputCount;
+    if (m_binary) {
+        if (m_remaining == 0) {
+            return false;
+        }
+        --m_remaining;
+        return fread (values, sizeof(float), width, m_file) == width;
+    }
+
+    while (getline (&line, &lineSize, m_file) > 0) {
+        ++lineNumber;
+        const char* p = line;
+        while (*p == ' ' || *p == '\t') ++p;
+        if (*p == '\0' || *p == '\n' || *p == '\r' || *p == '#') {
+            continue;
+        }
+
+        // width comma separated values and nothing else
+        size_t count = 0;
+        for (; count < width; ++count) {
+            char* end;
+            values[count] = parseFloat (p, &end);
+            if (end == p) break;
+            p = end;
+            while (*p == ' ' || *p == '\t') ++p;
+            if (count + 1 < width) {
+                if (*p != ',') break;
+                ++p;
+            }
+        }
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+        if (count == width && *p == '\0') {
+            return true;
+        }
+        printf ("warning: line %lu of the dataset does not have %lu values (skipped)\n", lineNumber, width);
+    }
+    return false;
+}
+
+// Waits until batch index may be filled
+// (both buffers are busy until the caller gives one back)
+bool DatasetReader::waitForBuffer (size_t index)
+{
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_changed.wait (lock, [this, index] { return m_stop || m_abort || index < m_released + 2; });
+    return !m_stop && !m_abort;
+}
+
+// Marks batch index as ready
+void DatasetReader::publish (size_t index, size_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_counts[index % 2] = count;
+        m_produced = index + 1;
+    }
+    m_changed.notify_all ();
+}
+
+//========================================================================
+
+// Writes count samples as a binary dataset
+bool DatasetReader::writeBinary (const char* path, const float* inputs, const float* answers,
+                                 size_t count, size_t inputCount, size_t outputCount)
+{
+    // Ensure params are valid
+    if (!path || (count > 0 && (!inputs || !answers))) {
+        printf ("error: please enter a valid path, inputs and answers\n");
+        return false;
+    }
+
+    FILE* file = fopen (path, "wb");
+    if (!file) {
+        printf ("error: could not open %s for writing\n", path);
+        return false;
+    }
+
+    DatasetHeader header;
+    memset (&header, 0, sizeof(header));
+    memcpy (header.m_magic, DATASET_MAGIC, sizeof(header.m_magic));
+    header.m_inputCount = inputCount;
+    header.m_outputCount = outputCount;
+    header.m_recordCount = count;
+
+    bool written = fwrite (&header, sizeof(header), 1, file) == 1;
+    for (size_t s = 0; written && s < count; ++s) {
+        written = fwrite (inputs + s * inputCount, sizeof(float), inputCount, file) == inputCount
+               && fwrite (answers + s * outputCount, sizeof(float), outputCount, file) == outputCount;
+    }
+    written = (fclose (file) == 0) && written;
+    if (!written) {
+        printf ("error: could not write %s\n", path);
+    }
+    return written;
+}
+
+//========================================================================
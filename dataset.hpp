@@ -0,0 +1,180 @@
+// Streaming Dataset Reader
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Streams training samples from a file in batches, so datasets do not
+// have to fit in memory. A background thread reads, parses and shuffles
+// the next batch while the caller trains on the current one:
+//
+//     DatasetReader reader ("train.bin", 784, 10, 64, 4096);
+//     for (size_t epoch = 0; epoch < epochs; ++epoch) {
+//         DatasetBatch batch;
+//         while (reader.next (batch)) {
+//             nn.trainBatch (batch.m_inputs, batch.m_answers, batch.m_count);
+//         }
+//         reader.rewind ();
+//     }
+//
+// Batches are laid out the way trainBatch, predictBatch and
+// ParallelTrainer take them (samples one after another) in 64 byte
+// aligned buffers, and are handed out in place (two buffers take turns).
+//
+// File formats (detected from the first bytes):
+// - binary: DatasetHeader then m_recordCount records of inputCount
+//   floats followed by outputCount floats (see writeBinary)
+// - CSV: one sample per line, inputCount values then outputCount values
+//   separated by commas. Empty lines and lines starting with '#' are
+//   skipped, lines with the wrong number of values are skipped with a
+//   warning (so a header line is fine).
+//
+// Shuffling uses a window of records: the window is filled from the
+// file and each sample is drawn at random from it, its place taken by
+// the next record read. Samples move at most about a window from where
+// they are in the file, a window as large as the file shuffles fully.
+// Every pass draws a new order (from seed and the pass number).
+//
+//========================================================================
+
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+//========================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "workspace.hpp"
+
+//========================================================================
+
+// first bytes of a binary dataset
+#define DATASET_MAGIC "SNNDATA1"
+
+struct DatasetHeader
+{
+    char     m_magic[8];
+    uint32_t m_inputCount;
+    uint32_t m_outputCount;
+    uint64_t m_recordCount;
+};
+
+// One batch of samples, valid until the next call to next() or rewind()
+struct DatasetBatch
+{
+    // m_count samples of inputCount values, one after another
+    const float* m_inputs;
+    // m_count samples of outputCount values, one after another
+    const float* m_answers;
+    // batchSize, except for the last batch of a pass
+    size_t m_count;
+};
+
+//========================================================================
+
+class DatasetReader
+{
+
+public:
+    size_t m_inputCount;
+    size_t m_outputCount;
+    size_t m_batchSize;
+    // records to shuffle over (0 keeps the file order)
+    size_t m_shuffleWindow;
+    unsigned m_seed;
+
+    // Opens a dataset and starts reading the first pass
+    // param path - a binary dataset or CSV file
+    // param inputCount, outputCount - values per sample (a binary
+    //       dataset must have the same counts)
+    // param batchSize - samples per batch
+    // param shuffleWindow - records to shuffle over, 0 for file order
+    // Note: check isOpen() afterwards, errors are printed
+    DatasetReader (const char* path, size_t inputCount, size_t outputCount,
+                   size_t batchSize, size_t shuffleWindow = 0, unsigned seed = 1);
+
+    // stops the background thread and closes the file
+    ~DatasetReader ();
+
+    DatasetReader (const DatasetReader&) = delete;
+    DatasetReader& operator= (const DatasetReader&) = delete;
+
+    // Returns true if the file was opened (and is a valid dataset)
+    bool isOpen () const;
+
+    // Hands out the next batch of this pass (waiting for it if it is not
+    // ready yet), returns false once the pass is over
+    // the previous batch is given back to the reader
+    bool next (DatasetBatch& batch);
+
+    // Starts another pass over the file from the beginning
+    // (the rest of the current pass is skipped)
+    void rewind ();
+
+    // Returns how long (in seconds) next() has waited for batches so far
+    // (0 means the reader always kept ahead of the caller)
+    double waitSeconds () const;
+
+    // Writes count samples as a binary dataset
+    // returns false (and prints why) if it could not
+    static bool writeBinary (const char* path, const float* inputs, const float* answers,
+                             size_t count, size_t inputCount, size_t outputCount);
+
+private:
+
+    FILE* m_file;
+    bool m_binary;
+    // where the records start (after the header)
+    long m_dataStart;
+    uint64_t m_recordCount;
+    // records of a binary dataset not read yet this pass
+    uint64_t m_remaining;
+
+    // two batches, each batchSize inputs then batchSize answers
+    Workspace m_buffers[2];
+    size_t m_counts[2];
+
+    // records waiting to be drawn (inputs then answers per record)
+    std::vector<float> m_window;
+
+    // shared with the background thread (guarded by m_mutex)
+    // batches of this pass: finished by the reader, handed out, given back
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    size_t m_produced;
+    size_t m_taken;
+    size_t m_released;
+    size_t m_pass;
+    bool m_passPending;
+    bool m_passDone;
+    bool m_abort;
+    bool m_stop;
+    double m_waitSeconds;
+
+    std::thread m_thread;
+
+    // Background thread: runs a pass whenever one is requested
+    void run ();
+
+    // Reads one pass, returns early if aborted or stopped
+    void readPass (size_t pass);
+
+    // Reads the next record into values (inputs then answers)
+    // returns false at the end of the file
+    bool readRecord (float* values, char*& line, size_t& lineSize, size_t& lineNumber);
+
+    // Waits until batch index may be filled, returns false if the pass
+    // should end instead
+    bool waitForBuffer (size_t index);
+
+    // Marks batch index (of count samples) as ready
+    void publish (size_t index, size_t count);
+
+};
+
+//========================================================================
+
+#endif
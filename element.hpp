@@ -0,0 +1,81 @@
+// Matrix Element Types
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Matrices and networks are templates over the element type they store.
+// Each element type has an accumulator type that sums, products and
+// scalars are computed in:
+//
+//     storage     accumulator
+//     float       float
+//     double      double
+//     bfloat16    float
+//
+// so narrow storage only narrows memory traffic, not the arithmetic.
+//
+//========================================================================
+
+#ifndef ELEMENT_HPP
+#define ELEMENT_HPP
+
+//========================================================================
+
+#include <stdint.h>
+#include <cstring> // memcpy
+
+//========================================================================
+
+// bfloat16 (brain floating point)
+// the top 16 bits of a float: same exponent range, 8 bits of precision
+// - converting from float rounds to nearest even (NaN stays NaN)
+// - converting to float is exact
+// there is no arithmetic on the type itself, values are widened to
+// float (the accumulator type) and rounded back when stored
+struct bfloat16
+{
+    uint16_t m_bits;
+
+    // uninitialized, like a float
+    bfloat16 () {}
+
+    bfloat16 (float value)
+    {
+        uint32_t bits;
+        memcpy (&bits, &value, sizeof(bits));
+        if ((bits & 0x7fffffff) > 0x7f800000) {
+            // NaN, keep it quiet (rounding could turn it into infinity)
+            m_bits = (uint16_t) ((bits >> 16) | 0x0040);
+        }
+        else {
+            m_bits = (uint16_t) ((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+        }
+    }
+
+    operator float () const
+    {
+        uint32_t bits = (uint32_t) m_bits << 16;
+        float value;
+        memcpy (&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+//========================================================================
+
+// Type that arithmetic on elements of type T is computed in
+template <typename T>
+struct Accumulator
+{
+    typedef T type;
+};
+
+template <>
+struct Accumulator<bfloat16>
+{
+    typedef float type;
+};
+
+//========================================================================
+
+#endif
@@ -0,0 +1,631 @@
+// General Matrix Multiply Engine
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include "gemm.hpp"
+#include "simd.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+// Register tile computed by the micro-kernel (MR rows x NR columns)
+static const size_t MR = 6;
+static const size_t NR = 16;
+
+// Cache blocking
+// - a KC x NR sliver of B and an MR x KC sliver of A should live in L1
+// - an MC x KC block of A should live in L2
+// - a KC x NC panel of B should live in L3
+static const size_t MC = 120;
+static const size_t KC = 256;
+static const size_t NC = 4096;
+
+// Problems with fewer multiply-adds than this skip packing
+static const size_t GEMM_SMALL = 32 * 32 * 32;
+
+// Problems with at least this many multiply-adds are split across threads
+static const size_t GEMM_PARALLEL = 128 * 128 * 128;
+
+// Number of tiles of C handed out per thread (more tiles balance better)
+static const size_t GEMM_TILES_PER_THREAD = 4;
+
+// Width in bytes of the vectors the micro-kernel accumulates in
+// (one AVX register or two SSE registers)
+static const size_t VECTOR_BYTES = 32;
+
+//========================================================================
+
+// Packing buffers are kept per thread and only ever grow
+// Acc is the accumulator type the panels are widened to
+template <typename Acc>
+struct PackBuffer
+{
+    Acc* m_data = nullptr;
+    size_t m_size = 0;
+
+    ~PackBuffer () { free (m_data); }
+
+    // Returns room for size elements
+    // returns nullptr (and leaves the buffer empty) if the allocation
+    // fails, so the next call tries again
+    Acc* reserve (size_t size)
+    {
+        if (size > m_size) {
+            free (m_data);
+            // 64 byte aligned so every row of a sliver starts a cache line
+            m_data = (Acc*) aligned_alloc (64, ((size * sizeof(Acc) + 63) / 64) * 64);
+            m_size = m_data ? size : 0;
+            if (!m_data) {
+                printf ("error: could not allocate a packing buffer of %lu elements\n", size);
+            }
+        }
+        return m_data;
+    }
+};
+
+// one pair of buffers per thread and accumulator type
+template <typename Acc>
+static PackBuffer<Acc>& packBufferA ()
+{
+    static thread_local PackBuffer<Acc> s_packA;
+    return s_packA;
+}
+
+template <typename Acc>
+static PackBuffer<Acc>& packBufferB ()
+{
+    static thread_local PackBuffer<Acc> s_packB;
+    return s_packB;
+}
+
+//========================================================================
+
+// Packs an mc x kc block of op(A) into MR-tall slivers
+// each sliver is stored column by column (MR values per k)
+// rows past the edge of A are zero-filled
+// elements are widened to the accumulator type Acc
+// - a points at element (0,0) of the block of op(A)
+template <typename T, typename Acc>
+static void packA (bool transA, size_t mc, size_t kc, const T* a, size_t lda, Acc* packed)
+{
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        size_t rows = (mc - ir < MR) ? mc - ir : MR;
+        for (size_t p = 0; p < kc; p++) {
+            if (transA) {
+                // a column of op(A) is a contiguous row of A
+                const T* col = a + p*lda + ir;
+                for (size_t i = 0; i < rows; i++) {
+                    packed[p*MR+i] = Acc (col[i]);
+                }
+            }
+            else {
+                for (size_t i = 0; i < rows; i++) {
+                    packed[p*MR+i] = Acc (a[(ir+i)*lda+p]);
+                }
+            }
+            for (size_t i = rows; i < MR; i++) {
+                packed[p*MR+i] = Acc (0);
+            }
+        }
+        packed += MR * kc;
+    }
+}
+
+// Packs a kc x nc panel of op(B) into NR-wide slivers
+// each sliver is stored row by row (NR values per k)
+// columns past the edge of B are zero-filled
+// elements are widened to the accumulator type Acc
+// - b points at element (0,0) of the panel of op(B)
+template <typename T, typename Acc>
+static void packB (bool transB, size_t kc, size_t nc, const T* b, size_t ldb, Acc* packed)
+{
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t cols = (nc - jr < NR) ? nc - jr : NR;
+        if (transB) {
+            // a row of op(B) is a column of B, so walk B row by row
+            // (one contiguous run of kc per output column)
+            for (size_t j = 0; j < cols; j++) {
+                const T* col = b + (jr+j)*ldb;
+                for (size_t p = 0; p < kc; p++) {
+                    packed[p*NR+j] = Acc (col[p]);
+                }
+            }
+            for (size_t p = 0; p < kc; p++) {
+                for (size_t j = cols; j < NR; j++) {
+                    packed[p*NR+j] = Acc (0);
+                }
+            }
+            packed += NR * kc;
+            continue;
+        }
+        for (size_t p = 0; p < kc; p++) {
+            const T* row = b + p*ldb + jr;
+            for (size_t j = 0; j < cols; j++) {
+                packed[p*NR+j] = Acc (row[j]);
+            }
+            for (size_t j = cols; j < NR; j++) {
+                packed[p*NR+j] = Acc (0);
+            }
+        }
+        packed += NR * kc;
+    }
+}
+
+//========================================================================
+
+// Micro-kernel
+// Accumulates an MR x NR tile of packed A * packed B in registers
+// then adds alpha times the tile into C
+// rows/cols give the valid part of the tile (for the edges of C)
+// the tile is held in vectors of VECTOR_BYTES (2 per row for float,
+// 4 per row for double)
+template <typename T, typename Acc>
+static inline __attribute__ ((always_inline))
+void microKernelBody (size_t kc, const Acc* ap, const Acc* bp,
+                      Acc alpha, T* c, size_t ldc,
+                      size_t rows, size_t cols)
+{
+    typedef Acc V __attribute__ ((vector_size (VECTOR_BYTES), may_alias));
+    const size_t LANES = VECTOR_BYTES / sizeof(Acc);
+    const size_t NV = NR / LANES;
+
+    V acc[MR][NV] = {};
+
+    for (size_t p = 0; p < kc; p++) {
+        V bv[NV];
+        #pragma GCC unroll 8
+        for (size_t v = 0; v < NV; v++) {
+            bv[v] = *(const V*) (bp + v*LANES);
+        }
+        #pragma GCC unroll 8
+        for (size_t i = 0; i < MR; i++) {
+            #pragma GCC unroll 8
+            for (size_t v = 0; v < NV; v++) {
+                acc[i][v] += bv[v] * ap[i];
+            }
+        }
+        ap += MR;
+        bp += NR;
+    }
+
+    Acc tile[MR*NR] __attribute__ ((aligned (64)));
+    #pragma GCC unroll 8
+    for (size_t i = 0; i < MR; i++) {
+        #pragma GCC unroll 8
+        for (size_t v = 0; v < NV; v++) {
+            *(V*) (tile + i*NR + v*LANES) = acc[i][v];
+        }
+    }
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            c[i*ldc+j] = T (Acc (c[i*ldc+j]) + alpha * tile[i*NR+j]);
+        }
+    }
+}
+
+// Baseline build of the micro-kernel (SSE2 on x86-64)
+template <typename T, typename Acc>
+static void microKernelGeneric (size_t kc, const Acc* ap, const Acc* bp,
+                                Acc alpha, T* c, size_t ldc,
+                                size_t rows, size_t cols)
+{
+    microKernelBody (kc, ap, bp, alpha, c, ldc, rows, cols);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// AVX2 + FMA build of the same micro-kernel
+template <typename T, typename Acc>
+__attribute__ ((target ("avx2,fma")))
+static void microKernelAvx2 (size_t kc, const Acc* ap, const Acc* bp,
+                             Acc alpha, T* c, size_t ldc,
+                             size_t rows, size_t cols)
+{
+    microKernelBody (kc, ap, bp, alpha, c, ldc, rows, cols);
+}
+#endif
+
+template <typename T, typename Acc>
+using MicroKernel = void (*) (size_t, const Acc*, const Acc*, Acc, T*, size_t, size_t, size_t);
+
+// Picks the widest micro-kernel this CPU can run
+template <typename T, typename Acc>
+static MicroKernel<T, Acc> selectMicroKernel ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma")) {
+        return microKernelAvx2<T, Acc>;
+    }
+#endif
+    return microKernelGeneric<T, Acc>;
+}
+
+//========================================================================
+
+// Straight loops for small problems
+// each element of C is summed over k in order (same as the textbook loop)
+// the loop order is picked so the innermost loop walks memory contiguously
+// (only used when elements are stored in their accumulator type)
+
+// Dot product of two contiguous rows
+// floats use the vectorized kernel (summed in vector lanes)
+static float dot (const float* a, const float* b, size_t n)
+{
+    return simd ().dot (a, b, n);
+}
+
+template <typename T>
+static T dot (const T* a, const T* b, size_t n)
+{
+    T sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// C += alpha * A * B  (i-k-j: rows of B and C are contiguous)
+template <typename T>
+static void gemmSmallNN (size_t m, size_t n, size_t k,
+                         T alpha,
+                         const T* a, size_t lda,
+                         const T* b, size_t ldb,
+                         T* c, size_t ldc)
+{
+    if (n == 1 && ldb == 1) {
+        // matrix * vector: one vectorized dot product per row of A
+        // (the only small case that does not keep the textbook order)
+        for (size_t i = 0; i < m; i++) {
+            c[i*ldc] += alpha * dot (a + i*lda, b, k);
+        }
+        return;
+    }
+    for (size_t i = 0; i < m; i++) {
+        T* crow = c + i*ldc;
+        for (size_t p = 0; p < k; p++) {
+            T aip = alpha * a[i*lda+p];
+            const T* brow = b + p*ldb;
+            for (size_t j = 0; j < n; j++) {
+                crow[j] += aip * brow[j];
+            }
+        }
+    }
+}
+
+// C += alpha * A^T * B  (k-i-j: each row of A scatters into C)
+// A is stored k x m
+template <typename T>
+static void gemmSmallTN (size_t m, size_t n, size_t k,
+                         T alpha,
+                         const T* a, size_t lda,
+                         const T* b, size_t ldb,
+                         T* c, size_t ldc)
+{
+    if (n == 1) {
+        // matrix^T * vector: one axpy per row of A
+        for (size_t p = 0; p < k; p++) {
+            T bp = alpha * b[p*ldb];
+            const T* arow = a + p*lda;
+            for (size_t i = 0; i < m; i++) {
+                c[i*ldc] += arow[i] * bp;
+            }
+        }
+        return;
+    }
+    for (size_t p = 0; p < k; p++) {
+        const T* arow = a + p*lda;
+        const T* brow = b + p*ldb;
+        for (size_t i = 0; i < m; i++) {
+            T api = alpha * arow[i];
+            T* crow = c + i*ldc;
+            for (size_t j = 0; j < n; j++) {
+                crow[j] += api * brow[j];
+            }
+        }
+    }
+}
+
+// C += alpha * A * B^T  (i-j-k: dot products of rows of A and rows of B)
+// B is stored n x k
+template <typename T>
+static void gemmSmallNT (size_t m, size_t n, size_t k,
+                         T alpha,
+                         const T* a, size_t lda,
+                         const T* b, size_t ldb,
+                         T* c, size_t ldc)
+{
+    if (k == 1) {
+        // outer product of two vectors
+        for (size_t i = 0; i < m; i++) {
+            T ai = alpha * a[i*lda];
+            T* crow = c + i*ldc;
+            for (size_t j = 0; j < n; j++) {
+                crow[j] += ai * b[j*ldb];
+            }
+        }
+        return;
+    }
+    for (size_t i = 0; i < m; i++) {
+        const T* arow = a + i*lda;
+        for (size_t j = 0; j < n; j++) {
+            const T* brow = b + j*ldb;
+            T sum = 0;
+            for (size_t p = 0; p < k; p++) {
+                sum += arow[p] * brow[p];
+            }
+            c[i*ldc+j] += alpha * sum;
+        }
+    }
+}
+
+// C += alpha * A^T * B^T  (no contiguous order exists, kept simple)
+template <typename T>
+static void gemmSmallTT (size_t m, size_t n, size_t k,
+                         T alpha,
+                         const T* a, size_t lda,
+                         const T* b, size_t ldb,
+                         T* c, size_t ldc)
+{
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            const T* brow = b + j*ldb;
+            T sum = 0;
+            for (size_t p = 0; p < k; p++) {
+                sum += a[p*lda+i] * brow[p];
+            }
+            c[i*ldc+j] += alpha * sum;
+        }
+    }
+}
+
+// Runs a small problem with the straight loops
+// returns false if the element type has to go through packing
+template <typename T>
+static bool gemmSmall (bool transA, bool transB,
+                       size_t m, size_t n, size_t k,
+                       T alpha,
+                       const T* a, size_t lda,
+                       const T* b, size_t ldb,
+                       T* c, size_t ldc)
+{
+    if      (!transA && !transB) gemmSmallNN (m, n, k, alpha, a, lda, b, ldb, c, ldc);
+    else if ( transA && !transB) gemmSmallTN (m, n, k, alpha, a, lda, b, ldb, c, ldc);
+    else if (!transA &&  transB) gemmSmallNT (m, n, k, alpha, a, lda, b, ldb, c, ldc);
+    else                         gemmSmallTT (m, n, k, alpha, a, lda, b, ldb, c, ldc);
+    return true;
+}
+
+// bfloat16 would round C on every multiply-add, so it always gets packed
+// (which widens it to float)
+static bool gemmSmall (bool, bool, size_t, size_t, size_t, float,
+                       const bfloat16*, size_t, const bfloat16*, size_t,
+                       bfloat16*, size_t)
+{
+    return false;
+}
+
+// Runs a product with straight loops whatever its size
+// (used when the packing buffers could not be allocated)
+template <typename T, typename Acc>
+static void gemmUnpacked (bool transA, bool transB,
+                          size_t m, size_t n, size_t k,
+                          Acc alpha,
+                          const T* a, size_t lda,
+                          const T* b, size_t ldb,
+                          T* c, size_t ldc)
+{
+    if (gemmSmall (transA, transB, m, n, k, alpha, a, lda, b, ldb, c, ldc)) {
+        return;
+    }
+    // element types that are packed to widen them (bfloat16) sum in Acc
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            Acc sum = 0;
+            for (size_t p = 0; p < k; p++) {
+                Acc ap = transA ? Acc (a[p*lda+i]) : Acc (a[i*lda+p]);
+                Acc bp = transB ? Acc (b[j*ldb+p]) : Acc (b[p*ldb+j]);
+                sum += ap * bp;
+            }
+            c[i*ldc+j] = T (Acc (c[i*ldc+j]) + alpha * sum);
+        }
+    }
+}
+
+//========================================================================
+
+// Blocked product C += alpha * op(A) * op(B) on the calling thread
+template <typename T, typename Acc>
+static void gemmBlocked (bool transA, bool transB,
+                         size_t m, size_t n, size_t k,
+                         Acc alpha,
+                         const T* a, size_t lda,
+                         const T* b, size_t ldb,
+                         T* c, size_t ldc)
+{
+    static const MicroKernel<T, Acc> kernel = selectMicroKernel<T, Acc> ();
+
+    size_t ncMax = (n < NC) ? n : NC;
+    size_t kcMax = (k < KC) ? k : KC;
+    size_t mcMax = (m < MC) ? m : MC;
+    Acc* packedB = packBufferB<Acc> ().reserve (kcMax * ((ncMax + NR - 1) / NR) * NR);
+    Acc* packedA = packBufferA<Acc> ().reserve (kcMax * ((mcMax + MR - 1) / MR) * MR);
+    if (!packedB || !packedA) {
+        gemmUnpacked (transA, transB, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+        return;
+    }
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = (n - jc < NC) ? n - jc : NC;
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = (k - pc < KC) ? k - pc : KC;
+            // element (pc,jc) of op(B)
+            const T* bBlock = transB ? b + jc*ldb + pc : b + pc*ldb + jc;
+            packB (transB, kc, nc, bBlock, ldb, packedB);
+
+            for (size_t ic = 0; ic < m; ic += MC) {
+                size_t mc = (m - ic < MC) ? m - ic : MC;
+                // element (ic,pc) of op(A)
+                const T* aBlock = transA ? a + pc*lda + ic : a + ic*lda + pc;
+                packA (transA, mc, kc, aBlock, lda, packedA);
+
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    size_t cols = (nc - jr < NR) ? nc - jr : NR;
+                    for (size_t ir = 0; ir < mc; ir += MR) {
+                        size_t rows = (mc - ir < MR) ? mc - ir : MR;
+                        kernel (kc, packedA + ir*kc, packedB + jr*kc, alpha,
+                                c + (ic+ir)*ldc + jc + jr, ldc, rows, cols);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//========================================================================
+
+// Computes C = alpha * op(A) * op(B) + beta * C
+template <typename T>
+void gemm (bool transA, bool transB,
+           size_t m, size_t n, size_t k,
+           typename Accumulator<T>::type alpha,
+           const T* a, size_t lda,
+           const T* b, size_t ldb,
+           typename Accumulator<T>::type beta,
+           T* c, size_t ldc)
+{
+    typedef typename Accumulator<T>::type Acc;
+
+    // C = beta * C
+    if (beta == Acc (0)) {
+        for (size_t i = 0; i < m; i++) {
+            std::fill_n (c + i*ldc, n, T (0));
+        }
+    }
+    else if (beta != Acc (1)) {
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                c[i*ldc+j] = T (Acc (c[i*ldc+j]) * beta);
+            }
+        }
+    }
+
+    if (m == 0 || n == 0 || k == 0 || alpha == Acc (0)) {
+        return;
+    }
+
+    // Packing does not pay off for vectors, outer products or tiny matrices
+    if (m == 1 || n == 1 || k == 1 || m * n * k <= GEMM_SMALL) {
+        if (gemmSmall (transA, transB, m, n, k, alpha, a, lda, b, ldb, c, ldc)) {
+            return;
+        }
+    }
+
+    // Large products are split into tiles of C, one task per tile
+    ThreadPool& pool = ThreadPool::global ();
+    size_t threads = pool.threadCount ();
+    if (threads == 1 || m * n * k < GEMM_PARALLEL) {
+        gemmBlocked (transA, transB, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+        return;
+    }
+
+    // pick a grid of roughly square tiles (in multiples of the register tile)
+    size_t wanted = threads * GEMM_TILES_PER_THREAD;
+    size_t rowTiles = (size_t) (sqrt ((double) wanted * m / n) + 0.5);
+    size_t maxRowTiles = (m + MR - 1) / MR;
+    if (rowTiles < 1) rowTiles = 1;
+    if (rowTiles > maxRowTiles) rowTiles = maxRowTiles;
+    size_t colTiles = (wanted + rowTiles - 1) / rowTiles;
+    size_t maxColTiles = (n + NR - 1) / NR;
+    if (colTiles > maxColTiles) colTiles = maxColTiles;
+
+    size_t tileRows = ((m + rowTiles - 1) / rowTiles + MR - 1) / MR * MR;
+    size_t tileCols = ((n + colTiles - 1) / colTiles + NR - 1) / NR * NR;
+    rowTiles = (m + tileRows - 1) / tileRows;
+    colTiles = (n + tileCols - 1) / tileCols;
+
+    // each task runs the blocked product on its own tile
+    // (with its own thread's packing buffers)
+    pool.parallelFor (rowTiles * colTiles, [&] (size_t tile) {
+        size_t i0 = (tile / colTiles) * tileRows;
+        size_t j0 = (tile % colTiles) * tileCols;
+        size_t rows = (m - i0 < tileRows) ? m - i0 : tileRows;
+        size_t cols = (n - j0 < tileCols) ? n - j0 : tileCols;
+        // row i0 of op(A) and column j0 of op(B)
+        const T* aTile = transA ? a + i0 : a + i0*lda;
+        const T* bTile = transB ? b + j0*ldb : b + j0;
+        gemmBlocked (transA, transB, rows, cols, k, alpha, aTile, lda, bTile, ldb,
+                     c + i0*ldc + j0, ldc);
+    });
+}
+
+//========================================================================
+
+// Adds s * x to a contiguous row
+// floats use the vectorized kernel
+static void axpy (float* dst, const float* x, float s, size_t n)
+{
+    simd ().axpy (dst, x, s, n);
+}
+
+template <typename T, typename Acc>
+static void axpy (T* dst, const T* x, Acc s, size_t n)
+{
+    for (size_t j = 0; j < n; j++) {
+        dst[j] = T (Acc (dst[j]) + s * Acc (x[j]));
+    }
+}
+
+// Rank-1 update A += alpha * x * y^T
+template <typename T>
+void ger (size_t m, size_t n,
+          typename Accumulator<T>::type alpha,
+          const T* x, size_t incx,
+          const T* y, size_t incy,
+          T* a, size_t lda)
+{
+    typedef typename Accumulator<T>::type Acc;
+
+    if (alpha == Acc (0)) {
+        return;
+    }
+
+    // each row of A gets a scaled copy of y added to it
+    if (incy == 1) {
+        for (size_t i = 0; i < m; i++) {
+            axpy (a + i*lda, y, alpha * Acc (x[i*incx]), n);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < m; i++) {
+        Acc s = alpha * Acc (x[i*incx]);
+        T* arow = a + i*lda;
+        for (size_t j = 0; j < n; j++) {
+            arow[j] = T (Acc (arow[j]) + s * Acc (y[j*incy]));
+        }
+    }
+}
+
+//========================================================================
+
+// Element types the engine is built for
+#define GEMM_INSTANTIATE(T)                                                     \
+    template void gemm<T> (bool, bool, size_t, size_t, size_t,                  \
+                           Accumulator<T>::type, const T*, size_t,              \
+                           const T*, size_t, Accumulator<T>::type, T*, size_t); \
+    template void ger<T> (size_t, size_t, Accumulator<T>::type,                 \
+                          const T*, size_t, const T*, size_t, T*, size_t);
+
+GEMM_INSTANTIATE (float)
+GEMM_INSTANTIATE (double)
+GEMM_INSTANTIATE (bfloat16)
+
+#undef GEMM_INSTANTIATE
+
+//========================================================================
@@ -0,0 +1,58 @@
+// General Matrix Multiply Engine
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+//========================================================================
+
+#include <stdlib.h>
+#include "element.hpp"
+
+//========================================================================
+
+// Computes C = alpha * op(A) * op(B) + beta * C
+// - op(X) is X, or X transposed when transX is set
+// - op(A) is m x k, op(B) is k x n and C is m x n
+// - all matrices are row-major, lda/ldb/ldc are the row strides of
+//   the matrices as stored (before any transpose)
+// - when beta is 0, C does not need to be initialized
+// Transposed operands are read in place, no transposed copy is made.
+// Large problems are cache blocked (panels of A and B are packed into
+// contiguous buffers) and computed by a register-tiled micro-kernel.
+// Small problems use a straight loop ordered for the access pattern
+// which keeps the summation order of the textbook triple loop
+// (except matrix * vector, which uses a vectorized dot product per row).
+// Large products are split into tiles of C that run on the library's
+// thread pool (see setNumThreads in threadpool.hpp).
+// Nothing is allocated per call: each thread keeps its packing buffers
+// and only grows them for a larger block than it has packed before.
+// Built for float, double and bfloat16 elements. Packing widens the
+// panels to the accumulator type (see element.hpp), so bfloat16 sums
+// in float. Reduced precision storage always takes the packed path and
+// C is rounded back to storage once per KC (256) slice of k.
+template <typename T>
+void gemm (bool transA, bool transB,
+           size_t m, size_t n, size_t k,
+           typename Accumulator<T>::type alpha,
+           const T* a, size_t lda,
+           const T* b, size_t ldb,
+           typename Accumulator<T>::type beta,
+           T* c, size_t ldc);
+
+// Rank-1 update A += alpha * x * y^T
+// - A is m x n (row-major, row stride lda)
+// - x has m elements spaced incx apart, y has n elements spaced incy apart
+// A is updated in place in a single pass, the outer product is never formed.
+template <typename T>
+void ger (size_t m, size_t n,
+          typename Accumulator<T>::type alpha,
+          const T* x, size_t incx,
+          const T* y, size_t incy,
+          T* a, size_t lda);
+
+//========================================================================
+
+#endif
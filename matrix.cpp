@@ -3,15 +3,209 @@
 // Date:   January 30 2022
 //========================================================================
 
+#include <stdint.h>
+#include <sys/mman.h>
 #include "matrix.hpp"
+#include "gemm.hpp"
+#include "simd.hpp"
+
+//========================================================================
+
+// Elementwise loops over contiguous arrays (dst may alias a source)
+// math is done in the accumulator type and rounded back once per element
+template <typename T>
+struct ElementOps
+{
+    typedef typename Accumulator<T>::type S;
+
+    static void add (T* dst, const T* a, const T* b, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (a[i]) + S (b[i]));
+    }
+    static void subtract (T* dst, const T* a, const T* b, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (a[i]) - S (b[i]));
+    }
+    static void multiply (T* dst, const T* a, const T* b, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (a[i]) * S (b[i]));
+    }
+    static void addScalar (T* dst, const T* a, S s, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (a[i]) + s);
+    }
+    static void subtractScalar (T* dst, const T* a, S s, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (a[i]) - s);
+    }
+    static void multiplyScalar (T* dst, const T* a, S s, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (a[i]) * s);
+    }
+    static void axpy (T* dst, const T* x, S s, size_t n) {
+        for (size_t i = 0; i < n; i++) dst[i] = T (S (dst[i]) + s * S (x[i]));
+    }
+    static bool equals (const T* a, const T* b, size_t n) {
+        for (size_t i = 0; i < n; i++) if (S (a[i]) != S (b[i])) return false;
+        return true;
+    }
+};
+
+// floats use the vectorized kernels (see simd.hpp)
+template <>
+struct ElementOps<float>
+{
+    static void add (float* dst, const float* a, const float* b, size_t n) { simd().add(dst, a, b, n); }
+    static void subtract (float* dst, const float* a, const float* b, size_t n) { simd().subtract(dst, a, b, n); }
+    static void multiply (float* dst, const float* a, const float* b, size_t n) { simd().multiply(dst, a, b, n); }
+    static void addScalar (float* dst, const float* a, float s, size_t n) { simd().addScalar(dst, a, s, n); }
+    static void subtractScalar (float* dst, const float* a, float s, size_t n) { simd().subtractScalar(dst, a, s, n); }
+    static void multiplyScalar (float* dst, const float* a, float s, size_t n) { simd().multiplyScalar(dst, a, s, n); }
+    static void axpy (float* dst, const float* x, float s, size_t n) { simd().axpy(dst, x, s, n); }
+    static bool equals (const float* a, const float* b, size_t n) { return simd().equals(a, b, n); }
+};
+
+// Runs op(dst, count) over the rows of a rows x cols matrix at dst with
+// row stride ld (one call over every element when there are no gaps)
+template <typename T, typename Op>
+static void eachRow (T* dst, size_t ld, size_t rows, size_t cols, Op op)
+{
+    if (ld == cols || rows <= 1) {
+        op (dst, rows * cols);
+        return;
+    }
+    for (size_t i = 0; i < rows; i++) {
+        op (dst + i * ld, cols);
+    }
+}
+
+// Same with the matching rows of a view x, op(dst, x, count)
+template <typename T, typename Op>
+static void eachRow (T* dst, size_t ld, const BasicMatrixView<T>& x, Op op)
+{
+    if ((ld == x.m_cols && x.contiguous ()) || x.m_rows <= 1) {
+        op (dst, x.m_data, x.m_rows * x.m_cols);
+        return;
+    }
+    for (size_t i = 0; i < x.m_rows; i++) {
+        op (dst + i * ld, x.m_data + i * x.m_ld, x.m_cols);
+    }
+}
+
+// Same with two views of the same shape, op(dst, a, b, count)
+template <typename T, typename Op>
+static void eachRow (T* dst, size_t ld, const BasicMatrixView<T>& a, const BasicMatrixView<T>& b, Op op)
+{
+    if ((ld == a.m_cols && a.contiguous () && b.contiguous ()) || a.m_rows <= 1) {
+        op (dst, a.m_data, b.m_data, a.m_rows * a.m_cols);
+        return;
+    }
+    for (size_t i = 0; i < a.m_rows; i++) {
+        op (dst + i * ld, a.m_data + i * a.m_ld, b.m_data + i * b.m_ld, a.m_cols);
+    }
+}
+
+// Returns the element stride of a vector view (one row or one column)
+template <typename T>
+static size_t vectorStride (const BasicMatrixView<T>& v)
+{
+    return (v.m_rows == 1) ? 1 : v.m_ld;
+}
+
+//========================================================================
+
+// STORAGE
+// Owned buffers start on a cache line (MATRIX_ALIGNMENT bytes) and the
+// rows of a matrix with more than one row and column are padded to whole
+// cache lines, so every row starts aligned. Buffers of MATRIX_MAP_BYTES
+// or more are mapped straight from the OS: their pages read as zero until
+// first written, so a blank matrix costs nothing to clear (smaller ones
+// come from calloc, which does not clear memory that is fresh from the OS
+// either).
+
+static const size_t MATRIX_MAP_BYTES = 128 * 1024;
+
+// Returns the row stride an owned rows x cols matrix is stored with
+// (vectors are not padded)
+template <typename T>
+size_t BasicMatrix<T>::paddedStride (size_t rows, size_t cols)
+{
+    if (rows <= 1 || cols <= 1) {
+        return cols;
+    }
+    size_t lanes = MATRIX_ALIGNMENT / sizeof(T);
+    return (cols + lanes - 1) / lanes * lanes;
+}
+
+// Returns the bytes a buffer of count elements takes (whole cache lines)
+template <typename T>
+static size_t bufferBytes (size_t count)
+{
+    return (count * sizeof(T) + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+}
+
+// Allocates an aligned buffer of count elements
+// zero - clear it (mapped buffers always start cleared)
+template <typename T>
+static T* allocateBuffer (size_t count, bool zero)
+{
+    size_t bytes = bufferBytes<T> (count);
+    if (bytes == 0) {
+        return nullptr;
+    }
+    if (bytes >= MATRIX_MAP_BYTES) {
+        void* data = mmap (nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return (data == MAP_FAILED) ? nullptr : (T*) data;
+    }
+    // one extra line to align the buffer in, the block to free is kept
+    // just before the buffer
+    void* block = zero ? calloc (1, bytes + MATRIX_ALIGNMENT) : malloc (bytes + MATRIX_ALIGNMENT);
+    if (!block) {
+        return nullptr;
+    }
+    unsigned char* data = (unsigned char*) block + MATRIX_ALIGNMENT - (uintptr_t) block % MATRIX_ALIGNMENT;
+    ((void**) data)[-1] = block;
+    return (T*) data;
+}
+
+// Frees a buffer of count elements from allocateBuffer
+template <typename T>
+static void freeBuffer (T* data, size_t count)
+{
+    if (!data) {
+        return;
+    }
+    size_t bytes = bufferBytes<T> (count);
+    if (bytes >= MATRIX_MAP_BYTES) {
+        munmap (data, bytes);
+    }
+    else {
+        free (((void**) data)[-1]);
+    }
+}
+
+// Copies rows x cols elements between buffers with the given row strides
+// (one copy when both are tightly packed)
+template <typename T>
+static void copyRows (T* dst, size_t dstLd, const T* src, size_t srcLd, size_t rows, size_t cols)
+{
+    if (rows * cols == 0) {
+        return;
+    }
+    if ((dstLd == cols && srcLd == cols) || rows == 1) {
+        memcpy (dst, src, rows * cols * sizeof(T));
+        return;
+    }
+    for (size_t i = 0; i < rows; i++) {
+        memcpy (dst + i*dstLd, src + i*srcLd, cols * sizeof(T));
+    }
+}
 
 //========================================================================
 
 // default ctor 
-Matrix::Matrix ()
+template <typename T>
+BasicMatrix<T>::BasicMatrix ()
 {
     m_rows = 0;
     m_cols = 0; 
+    m_ld = 0;
+    m_capacity = 0;
+    m_owner = true;
     m_data = nullptr; 
 }
 
@@ -20,85 +214,201 @@ Matrix::Matrix ()
 // Ctor 
 // Constructs a blank (zero-valued) matrix 
 // with given dimensions
-Matrix::Matrix (size_t rows, size_t cols) 
+template <typename T>
+BasicMatrix<T>::BasicMatrix (size_t rows, size_t cols) 
 {
 
     m_rows = rows;
     m_cols = cols;
-    m_data = (float*) malloc (rows * cols * sizeof(float));
+    m_ld = paddedStride (rows, cols);
+    m_capacity = rows * m_ld;
+    m_owner = true;
+    // initialize matrix data (zeroed with the allocation)
+    m_data = allocateBuffer<T> (m_capacity, true);
 
-    // initialize matrix data
-    for (size_t i = 0; i < rows; i++) {
-        for (size_t j = 0; j < cols; j++) {
-            m_data[i*m_cols+j] = 0.0f;
-        }
+}
+
+// Constructs a matrix over existing memory 
+template <typename T>
+BasicMatrix<T>::BasicMatrix (size_t rows, size_t cols, T* data, size_t ld)
+{
+    m_rows = rows;
+    m_cols = cols;
+    m_ld = ld ? ld : cols;
+    m_capacity = rows * m_ld;
+    m_owner = false;
+    m_data = data;
+}
+
+// Constructs a matrix holding a copy of a view
+template <typename T>
+BasicMatrix<T>::BasicMatrix (const View& view)
+    : BasicMatrix ()
+{
+    resize (view.m_rows, view.m_cols);
+    copyRows (m_data, m_ld, view.m_data, view.m_ld, m_rows, m_cols);
+}
+
+//========================================================================
+
+// Copy ctor (deep copy)
+template <typename T>
+BasicMatrix<T>::BasicMatrix (const BasicMatrix& other)
+    : BasicMatrix ()
+{
+    resize (other.m_rows, other.m_cols);
+    copyRows (m_data, m_ld, other.m_data, other.m_ld, m_rows, m_cols);
+}
+
+// Move ctor (steals the buffer)
+template <typename T>
+BasicMatrix<T>::BasicMatrix (BasicMatrix&& other) noexcept
+{
+    m_rows = other.m_rows;
+    m_cols = other.m_cols;
+    m_ld = other.m_ld;
+    m_capacity = other.m_capacity;
+    m_owner = other.m_owner;
+    m_data = other.m_data;
+
+    other.m_rows = 0;
+    other.m_cols = 0;
+    other.m_ld = 0;
+    other.m_capacity = 0;
+    other.m_owner = true;
+    other.m_data = nullptr;
+}
+
+// Copy assignment
+// reuses this matrix's buffer when it is big enough
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator= (const BasicMatrix& other)
+{
+    if (this == &other) {
+        return *this;
     }
 
+    resize (other.m_rows, other.m_cols);
+    copyRows (m_data, m_ld, other.m_data, other.m_ld, m_rows, m_cols);
+    return *this;
+}
+
+// Move assignment (steals the buffer)
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator= (BasicMatrix&& other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    if (m_owner) {
+        freeBuffer (m_data, m_capacity);
+    }
+
+    m_rows = other.m_rows;
+    m_cols = other.m_cols;
+    m_ld = other.m_ld;
+    m_capacity = other.m_capacity;
+    m_owner = other.m_owner;
+    m_data = other.m_data;
+
+    other.m_rows = 0;
+    other.m_cols = 0;
+    other.m_ld = 0;
+    other.m_capacity = 0;
+    other.m_owner = true;
+    other.m_data = nullptr;
+    return *this;
+}
+
+// Dtor
+template <typename T>
+BasicMatrix<T>::~BasicMatrix ()
+{
+    if (m_owner) {
+        freeBuffer (m_data, m_capacity);
+    }
 }
 
 // DATA 
 // ================================================================
 
-void Matrix::setData (float* data) 
+// Copies rows*cols # of data into this matrix
+template <typename T>
+void BasicMatrix<T>::setData (const T* data) 
 {
-    if (!data || sizeof(data)==0) {
+    if (!data) {
         printf ("error: data entered is not a 2 dimensional array\n");
         return;
     }
 
-    m_data = data;
+    copyRows (m_data, m_ld, data, m_cols, m_rows, m_cols);
 
 }
 
-// Randomly generates data 
-void Matrix::randomize()
+// Changes the dimensions of this matrix 
+// the buffer is only reallocated if it is too small 
+template <typename T>
+void BasicMatrix<T>::resize (size_t rows, size_t cols)
 {
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            // generates a number between -1 and 1 
-            m_data[i*m_cols+j] = ((float(rand()) / float(RAND_MAX)) * (1.0 - -1.0)) + -1.0;
+    if (rows == m_rows && cols == m_cols) {
+        return;
+    }
+
+    // padded rows when the memory has room for them (external memory
+    // that was sized for tightly packed rows stays packed)
+    size_t ld = paddedStride (rows, cols);
+    if (!m_owner && rows * ld > m_capacity) {
+        ld = cols;
+    }
+    if (rows * ld > m_capacity) {
+        if (m_owner) {
+            freeBuffer (m_data, m_capacity);
         }
+        ld = paddedStride (rows, cols);
+        m_capacity = rows * ld;
+        m_owner = true;
+        m_data = allocateBuffer<T> (m_capacity, false);
     }
+    m_rows = rows;
+    m_cols = cols;
+    m_ld = ld;
 }
 
-// Returns a copy of this matrix 
-Matrix Matrix::copy()
+// Randomly generates data 
+template <typename T>
+void BasicMatrix<T>::randomize()
 {
-    // Creates new matrix 
-    Matrix newMatrix (m_rows, m_cols);
-
-    // Copy data to new matrix 
     for(size_t i = 0; i < m_rows; i++){
         for(size_t j = 0; j < m_cols; j++){
-            newMatrix.m_data[i*m_cols+j] = m_data[i*m_cols+j];
+            // generates a number between -1 and 1 
+            m_data[i*m_ld+j] = ((float(rand()) / float(RAND_MAX)) * (1.0 - -1.0)) + -1.0;
         }
     }
+}
 
-    return newMatrix;
+// Returns a copy of this matrix 
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::copy() const
+{
+    // Creates new matrix (with a copy of the data)
+    return BasicMatrix (*this);
 
 }
 
 // Returns this matrix transposed
 // -Rows become columns 
 // -Columns become rows
-Matrix Matrix::transpose(){
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::transpose() const {
     
-    // Create new transposed matrix
-    Matrix transposedMatrix (m_cols, m_rows);
-
-    // Transpose Data
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            transposedMatrix.m_data[j*m_rows+i] = m_data[i*m_cols+j];
-        }
-    }
-
-    return transposedMatrix;
+    return transpose (View (*this));
 
 }
 
 // Converts this matrix to an array if there is only one column or one row
-float* Matrix::toArray()
+template <typename T>
+T* BasicMatrix<T>::toArray() const
 {
 
     // Ensure matrix can be simplified down to an array
@@ -110,9 +420,9 @@ float* Matrix::toArray()
     }
 
     // Convert to array 
-    // 1 row || 1 column (stored the same either way, no data transfer)
-    float* arr = (float*) malloc (m_rows*m_cols*sizeof(float));
-    memcpy (arr, m_data, m_rows*m_cols*sizeof(float));
+    // (a column is spaced by the row stride)
+    T* arr = (T*) malloc (m_rows*m_cols*sizeof(T));
+    copyRows (arr, m_cols, m_data, m_ld, m_rows, m_cols);
     return arr;
 
 }
@@ -120,17 +430,18 @@ float* Matrix::toArray()
 // Creates a matrix from an array 
 // the array is converted from a single row to a single column by default
 // use Const SINGLE_ROW/SINGLE_COLUMN
-Matrix Matrix::fromArray(float* arr, int n, int type)
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::fromArray(const T* arr, int n, int type)
 {
     // Single Column Format 
+    // (vectors are never padded, so the elements are contiguous)
     if(type == SINGLE_COLUMN) {
         // Create matrix 
-        Matrix matrix (n, 1);
+        BasicMatrix matrix;
+        matrix.resize (n, 1);
 
         // Add data to matrix 
-        for(size_t i = 0; i < matrix.m_rows; i++){
-            matrix.m_data[i] = arr[i];
-        }
+        matrix.setData (arr);
 
         return matrix;
     } 
@@ -138,12 +449,11 @@ Matrix Matrix::fromArray(float* arr, int n, int type)
     // Single Row Format
     else {
         // Create matrix 
-        Matrix matrix (1, n);
+        BasicMatrix matrix;
+        matrix.resize (1, n);
 
         // Add data to matrix 
-        for(size_t i = 0; i < matrix.m_cols; i++){
-            matrix.m_data[i] = arr[i];
-        }
+        matrix.setData (arr);
 
         return matrix;
     }
@@ -156,14 +466,14 @@ Matrix Matrix::fromArray(float* arr, int n, int type)
 
 // Adds a scalar or another matrix to this matrix 
 // Note: this matrix is affected while the other is not
-void Matrix::add(float n){
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            m_data[i*m_cols+j] += n;
-        }
-    }
+template <typename T>
+void BasicMatrix<T>::add(Scalar n){
+    eachRow(m_data, m_ld, m_rows, m_cols, [n] (T* dst, size_t count) {
+        ElementOps<T>::addScalar(dst, dst, n, count);
+    });
 }
-void Matrix::add(Matrix n){
+template <typename T>
+void BasicMatrix<T>::add(const View& n){
     // Ensure matrices have the same dimensions
     if(n.m_rows != m_rows || n.m_cols != m_cols){
         printf("error: matrices must have the same dimensions\n");
@@ -174,23 +484,21 @@ void Matrix::add(Matrix n){
     }
 
     // Add cooresponding elements to this matrix
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            m_data[i*m_cols+j] += n.m_data[i*n.m_cols+j];
-        }
-    }
+    eachRow(m_data, m_ld, n, [] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::add(dst, dst, x, count);
+    });
 }
 
 // Subtracts a scalar or another matrix to this matrix 
 // Note: this matrix is affected while the other is not
-void Matrix::subtract(float n){
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            m_data[i*m_cols+j] -= n;
-        }
-    }
+template <typename T>
+void BasicMatrix<T>::subtract(Scalar n){
+    eachRow(m_data, m_ld, m_rows, m_cols, [n] (T* dst, size_t count) {
+        ElementOps<T>::subtractScalar(dst, dst, n, count);
+    });
 }
-void Matrix::subtract(Matrix n){
+template <typename T>
+void BasicMatrix<T>::subtract(const View& n){
     // Ensure matrices have the same dimensions
     if(n.m_rows != m_rows || n.m_cols != m_cols){
         printf("error: matrices must have the same dimensions\n");
@@ -201,22 +509,20 @@ void Matrix::subtract(Matrix n){
     }
 
     // Add cooresponding elements to this matrix
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            m_data[i*m_cols+j] -= n.m_data[i*n.m_cols+j];
-        }
-    }
+    eachRow(m_data, m_ld, n, [] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::subtract(dst, dst, x, count);
+    });
 }
 
 // Multiplies this matrix by a scalar value or another matrix
-void Matrix::multiply(float n){
-    for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            m_data[i*m_cols+j] *= n;
-        }
-    }
+template <typename T>
+void BasicMatrix<T>::multiply(Scalar n){
+    eachRow(m_data, m_ld, m_rows, m_cols, [n] (T* dst, size_t count) {
+        ElementOps<T>::multiplyScalar(dst, dst, n, count);
+    });
 }
-void Matrix::multiply(Matrix n){
+template <typename T>
+void BasicMatrix<T>::multiply(const View& n){
     // Ensure matrices have the same dimensions
     if(n.m_rows != m_rows || n.m_cols != m_cols){
         printf("error: matrices must have the same dimensions\n");
@@ -227,84 +533,176 @@ void Matrix::multiply(Matrix n){
     }
 
     // Add cooresponding elements to this matrix
+    eachRow(m_data, m_ld, n, [] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::multiply(dst, dst, x, count);
+    });
+}
+
+// Adds a scaled matrix to this matrix (this += alpha * x)
+template <typename T>
+void BasicMatrix<T>::addScaled(Scalar alpha, const View& x){
+    // Ensure matrices have the same dimensions
+    if(x.m_rows != m_rows || x.m_cols != m_cols){
+        printf("error: matrices must have the same dimensions\n");
+        printf("to preform elementwise operation\n");
+        printf("this: %lux%lu\n", m_rows, m_cols);
+        printf("addend: %lux%lu\n", x.m_rows, x.m_cols);
+        return;
+    }
+
+    eachRow(m_data, m_ld, x, [alpha] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::axpy(dst, x, alpha, count);
+    });
+}
+
+// Adds a scaled outer product to this matrix (this += alpha * x * y^T)
+template <typename T>
+void BasicMatrix<T>::addOuterProduct(Scalar alpha, const View& x, const View& y){
+    // Ensure x and y are vectors that match this matrix
+    if((x.m_rows != 1 && x.m_cols != 1) || (y.m_rows != 1 && y.m_cols != 1)
+        || x.m_rows*x.m_cols != m_rows || y.m_rows*y.m_cols != m_cols){
+        printf("error: outer product does not match this matrix\n");
+        printf("this: %lux%lu\n", m_rows, m_cols);
+        printf("x: %lux%lu\n", x.m_rows, x.m_cols);
+        printf("y: %lux%lu\n", y.m_rows, y.m_cols);
+        return;
+    }
+
+    // a row is contiguous, a column is spaced by its view's row stride
+    ger(m_rows, m_cols, alpha, x.m_data, vectorStride(x), y.m_data, vectorStride(y), m_data, m_ld);
+}
+
+// Adds a scaled matrix product to this matrix (this += alpha * a * b)
+template <typename T>
+void BasicMatrix<T>::addProduct(Scalar alpha, const View& a, const View& b){
+    // Ensure the product matches this matrix 
+    if(a.m_cols != b.m_rows || a.m_rows != m_rows || b.m_cols != m_cols){
+        printf("error: product does not match this matrix\n");
+        printf("this: %lux%lu\n", m_rows, m_cols);
+        printf("a: %lux%lu\n", a.m_rows, a.m_cols);
+        printf("b: %lux%lu\n", b.m_rows, b.m_cols);
+        return;
+    }
+
+    gemm(false, false, m_rows, m_cols, a.m_cols,
+         alpha, a.m_data, a.m_ld,
+         b.m_data, b.m_ld,
+         1.0f, m_data, m_ld);
+}
+// Adds a scaled matrix product to this matrix (this += alpha * a * b^T)
+template <typename T>
+void BasicMatrix<T>::addProductNT(Scalar alpha, const View& a, const View& b){
+    // Ensure the product matches this matrix 
+    if(a.m_cols != b.m_cols || a.m_rows != m_rows || b.m_rows != m_cols){
+        printf("error: product does not match this matrix\n");
+        printf("this: %lux%lu\n", m_rows, m_cols);
+        printf("a: %lux%lu\n", a.m_rows, a.m_cols);
+        printf("b^T: %lux%lu\n", b.m_cols, b.m_rows);
+        return;
+    }
+
+    gemm(false, true, m_rows, m_cols, a.m_cols,
+         alpha, a.m_data, a.m_ld,
+         b.m_data, b.m_ld,
+         1.0f, m_data, m_ld);
+}
+
+// Adds a column vector to every column of this matrix 
+template <typename T>
+void BasicMatrix<T>::addColumnVector(const View& v){
+    // Ensure v is a column with one element per row
+    if(v.m_rows != m_rows || v.m_cols != 1){
+        printf("error: column vector does not match this matrix\n");
+        printf("this: %lux%lu\n", m_rows, m_cols);
+        printf("v: %lux%lu\n", v.m_rows, v.m_cols);
+        return;
+    }
+
     for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            m_data[i*m_cols+j] *= n.m_data[i*n.m_cols+j];
-        }
+        ElementOps<T>::addScalar(m_data+i*m_ld, m_data+i*m_ld, v.m_data[i*v.m_ld], m_cols);
     }
 }
 
+// Adds the scaled sum of the columns of m to this column vector
+template <typename T>
+void BasicMatrix<T>::addScaledRowSums(Scalar alpha, const View& m){
+    // Ensure this is a column with one element per row of m
+    if(m_rows != m.m_rows || m_cols != 1){
+        printf("error: matrix does not match this column vector\n");
+        printf("this: %lux%lu\n", m_rows, m_cols);
+        printf("m: %lux%lu\n", m.m_rows, m.m_cols);
+        return;
+    }
+
+    for(size_t i = 0; i < m_rows; i++){
+        Scalar sum = 0;
+        for(size_t j = 0; j < m.m_cols; j++){
+            sum += Scalar (m.m_data[i*m.m_ld+j]);
+        }
+        m_data[i*m_ld] = T (Scalar (m_data[i*m_ld]) + alpha * sum);
+    }
+}
 
 // Tests if a given matrix equals this matrix
-bool Matrix::equals(Matrix m){
+template <typename T>
+bool BasicMatrix<T>::equals(const View& m) const {
     // Ensure that given matrix matches the dimensions of this matrix 
     if(m.m_rows != m_rows || m.m_cols != m_cols){
         return false;
     }
 
     // Ensure data matches 
+    if(contiguous() && m.contiguous()){
+        return ElementOps<T>::equals(m_data, m.m_data, m_rows*m_cols);
+    }
     for(size_t i = 0; i < m_rows; i++){
-        for(size_t j = 0; j < m_cols; j++){
-            // Returns false if elements are not equal
-            if(m_data[i*m_cols+j] != m.m_data[i*m.m_cols+j]){
-                return false;
-            }
+        if(!ElementOps<T>::equals(m_data+i*m_ld, m.m_data+i*m.m_ld, m_cols)){
+            return false;
         }
     }
     return true;
 }
 
-// Applies a given function to each element of this matrix
-void Matrix::map(float (*f)(float)){
-    for(size_t i = 0; i < m_rows; i++) {
-        for(size_t j = 0; j < m_cols; j++){
-            // pass through function
-            m_data[i*m_cols+j] = f(m_data[i*m_cols+j]);
-        }
-    }
-}
-
 // // STATIC METHODS: MATH 
 // // ================================================================
 
 // Adds a scalar to a matrix or adds two matrices together elementwise
 // note: none of the matrices are altered 
 // the result is return as a new matrix
-Matrix Matrix::add (float a, Matrix b){
-    Matrix c (b.m_rows, b.m_cols);
-    for(size_t i = 0; i < b.m_rows; i++){
-        for(size_t j = 0; j < b.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = b.m_data[i*b.m_cols+j] + a;
-        }
-    } 
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::add (Scalar a, const View& b){
+    BasicMatrix c;
+    c.resize(b.m_rows, b.m_cols);
+    eachRow(c.m_data, c.m_ld, b, [a] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::addScalar(dst, x, a, count);
+    });
     return c;
 }
-Matrix Matrix::add (Matrix a, float b){
-    Matrix c (a.m_rows, a.m_cols);
-    for(size_t i = 0; i < a.m_rows; i++){
-        for(size_t j = 0; j < a.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = a.m_data[i*a.m_cols+j] + b;
-        }
-    }
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::add (const View& a, Scalar b){
+    BasicMatrix c;
+    c.resize(a.m_rows, a.m_cols);
+    eachRow(c.m_data, c.m_ld, a, [b] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::addScalar(dst, x, b, count);
+    });
     return c; 
 }
-Matrix Matrix::add (Matrix a, Matrix b){
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::add (const View& a, const View& b){
     // Ensure matrices have the same dimensions
     if(b.m_rows != a.m_rows || b.m_cols != a.m_cols){
         printf ("matrices must have the same dimensions\n");
         printf ("to preform elementwise operation\n");
         printf ("a: %lux%lu\n", a.m_rows, a.m_cols);
         printf ("b: %lux%lu\n", b.m_rows, b.m_cols);
-        return Matrix();
+        return BasicMatrix();
     }
 
-    Matrix c (a.m_rows, a.m_cols);
-    // Add cooresponding elements to this matrix
-    for(size_t i = 0; i < a.m_rows; i++){
-        for(size_t j = 0; j < a.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = a.m_data[i*a.m_cols+j] + b.m_data[i*b.m_cols+j];
-        }
-    }
+    BasicMatrix c;
+    c.resize(a.m_rows, a.m_cols);
+    eachRow(c.m_data, c.m_ld, a, b, [] (T* dst, const T* x, const T* y, size_t count) {
+        ElementOps<T>::add(dst, x, y, count);
+    });
     return c; 
 }
 
@@ -312,129 +710,203 @@ Matrix Matrix::add (Matrix a, Matrix b){
 // note: none of the matrices are altered 
 // the result is return as a new matrix
 // first param should be the matrix 
-Matrix Matrix::subtract (float a, Matrix b){
-    Matrix c (b.m_rows, b.m_cols);
-    for(size_t i = 0; i < b.m_rows; i++){
-        for(size_t j = 0; j < b.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = b.m_data[i*b.m_cols+j] - a;
-        }
-    } 
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::subtract (Scalar a, const View& b){
+    BasicMatrix c;
+    c.resize(b.m_rows, b.m_cols);
+    eachRow(c.m_data, c.m_ld, b, [a] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::subtractScalar(dst, x, a, count);
+    });
     return c;
 }
-Matrix Matrix::subtract (Matrix a, float b){
-    Matrix c (a.m_rows, a.m_cols);
-    for(size_t i = 0; i < a.m_rows; i++){
-        for(size_t j = 0; j < a.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = a.m_data[i*a.m_cols+j] - b;
-        }
-    }
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::subtract (const View& a, Scalar b){
+    BasicMatrix c;
+    c.resize(a.m_rows, a.m_cols);
+    eachRow(c.m_data, c.m_ld, a, [b] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::subtractScalar(dst, x, b, count);
+    });
     return c; 
 }
-Matrix Matrix::subtract (Matrix a, Matrix b){
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::subtract (const View& a, const View& b){
     // Ensure matrices have the same dimensions
     if(b.m_rows != a.m_rows || b.m_cols != a.m_cols){
         printf ("matrices must have the same dimensions\n");
         printf ("to preform elementwise operation\n");
         printf ("a: %lux%lu\n", a.m_rows, a.m_cols);
         printf ("b: %lux%lu\n", b.m_rows, b.m_cols);
-        return Matrix();
+        return BasicMatrix();
     }
 
-    Matrix c (a.m_rows, a.m_cols);
-    // Add cooresponding elements to this matrix
-    for(size_t i = 0; i < a.m_rows; i++){
-        for(size_t j = 0; j < a.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = a.m_data[i*a.m_cols+j] - b.m_data[i*b.m_cols+j];
-        }
-    }
+    BasicMatrix c;
+    c.resize(a.m_rows, a.m_cols);
+    eachRow(c.m_data, c.m_ld, a, b, [] (T* dst, const T* x, const T* y, size_t count) {
+        ElementOps<T>::subtract(dst, x, y, count);
+    });
     return c; 
 }
 
 // Multiplies a matrix by a scalar value or another matrix
 // uses hadamard product 
 // returns the new matrix 
-Matrix Matrix::multiply (float a, Matrix b){
-    Matrix c (b.m_rows, b.m_cols);
-    for(size_t i = 0; i < b.m_rows; i++){
-        for(size_t j = 0; j < b.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = b.m_data[i*b.m_cols+j] * a;
-        }
-    } 
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::multiply (Scalar a, const View& b){
+    BasicMatrix c;
+    c.resize(b.m_rows, b.m_cols);
+    eachRow(c.m_data, c.m_ld, b, [a] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::multiplyScalar(dst, x, a, count);
+    });
     return c;
 }
-Matrix Matrix::multiply (Matrix a, float b){
-    Matrix c (a.m_rows, a.m_cols);
-    for(size_t i = 0; i < a.m_rows; i++){
-        for(size_t j = 0; j < a.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = a.m_data[i*a.m_cols+j] * b;
-        }
-    }
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::multiply (const View& a, Scalar b){
+    BasicMatrix c;
+    c.resize(a.m_rows, a.m_cols);
+    eachRow(c.m_data, c.m_ld, a, [b] (T* dst, const T* x, size_t count) {
+        ElementOps<T>::multiplyScalar(dst, x, b, count);
+    });
     return c; 
 }
-Matrix Matrix::multiply (Matrix a, Matrix b){
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::multiply (const View& a, const View& b){
     // Ensure matrices have the same dimensions
     if(b.m_rows != a.m_rows || b.m_cols != a.m_cols){
         printf ("matrices must have the same dimensions\n");
         printf ("to preform elementwise operation\n");
         printf ("a: %lux%lu\n", a.m_rows, a.m_cols);
         printf ("b: %lux%lu\n", b.m_rows, b.m_cols);
-        return Matrix();
+        return BasicMatrix();
     }
 
-    Matrix c (a.m_rows, a.m_cols);
-    // Add cooresponding elements to this matrix
-    for(size_t i = 0; i < a.m_rows; i++){
-        for(size_t j = 0; j < a.m_cols; j++){
-            c.m_data[i*c.m_cols+j] = a.m_data[i*a.m_cols+j] * b.m_data[i*b.m_cols+j];
-        }
-    }
+    BasicMatrix c;
+    c.resize(a.m_rows, a.m_cols);
+    eachRow(c.m_data, c.m_ld, a, b, [] (T* dst, const T* x, const T* y, size_t count) {
+        ElementOps<T>::multiply(dst, x, y, count);
+    });
     return c; 
 }
 
 // Multiplies two given matrices together 
 // Using the matrix product method
-Matrix Matrix::product (Matrix a, Matrix b){
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::product (const View& a, const View& b){
+    BasicMatrix product;
+    productInto (a, b, product);
+    return product;
+}
+
+// Multiplies the transpose of 'a' by 'b' (a^T * b)
+// 'a' is read in place, no transposed copy is made
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::productTN (const View& a, const View& b){
+    BasicMatrix product;
+    productTNInto (a, b, product);
+    return product;
+}
+
+// Multiplies 'a' by the transpose of 'b' (a * b^T)
+// 'b' is read in place, no transposed copy is made
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::productNT (const View& a, const View& b){
+    BasicMatrix product;
+    productNTInto (a, b, product);
+    return product;
+}
+
+// Same as product but written into result
+template <typename T>
+void BasicMatrix<T>::productInto (const View& a, const View& b, BasicMatrix& result){
 
     // Ensure Matrix Multiplication can be applied
     // - Columns of 'a' must equal rows of 'b'
-    if(a.m_cols == b.m_rows){
+    if(a.m_cols != b.m_rows){
+        printf ("matrices cannot be multiplied\n");
+        printf ("columns of a must equal rows of b\n");
+        printf ("a: %lux%lu\n", a.m_rows, a.m_cols);
+        printf ("b: %lux%lu\n", b.m_rows, b.m_cols);
+        result = BasicMatrix();
+        return;
+    }
 
-        // Create Product matrix
-        // - with rows of 'a' and columns of 'b'
-        Matrix product (a.m_rows, b.m_cols);
+    // Product matrix
+    // - with rows of 'a' and columns of 'b'
+    result.resize (a.m_rows, b.m_cols);
 
-        // Each row of 'a' multiplied by each column of 'b'
-        for (size_t i = 0; i < a.m_rows; i++){
-            for (size_t j = 0; j < b.m_cols; j++){
+    // Each row of 'a' multiplied by each column of 'b'
+    // (blocked GEMM, see gemm.hpp)
+    gemm (false, false, a.m_rows, b.m_cols, a.m_cols,
+          1.0f, a.m_data, a.m_ld,
+          b.m_data, b.m_ld,
+          0.0f, result.m_data, result.m_ld);
 
-                // dot-product
-                // each elem in 'a's row are
-                // multiplied by cooresponding elements in 'b's column
-                // and added together 
-                for (size_t elem = 0; elem < a.m_cols; elem++){
-                    product.m_data[i*product.m_cols+j] += a.m_data[i*a.m_cols+elem] * b.m_data[elem*b.m_cols+j]; 
-                }
+}
 
-            }
-        }
+// Same as productTN but written into result
+template <typename T>
+void BasicMatrix<T>::productTNInto (const View& a, const View& b, BasicMatrix& result){
+
+    // Ensure Matrix Multiplication can be applied
+    // - Rows of 'a' must equal rows of 'b'
+    if(a.m_rows != b.m_rows){
+        printf ("matrices cannot be multiplied\n");
+        printf ("rows of a must equal rows of b\n");
+        printf ("a: %lux%lu\n", a.m_rows, a.m_cols);
+        printf ("b: %lux%lu\n", b.m_rows, b.m_cols);
+        result = BasicMatrix();
+        return;
+    }
 
-        return product;
+    // - with columns of 'a' and columns of 'b'
+    result.resize (a.m_cols, b.m_cols);
 
+    gemm (true, false, a.m_cols, b.m_cols, a.m_rows,
+          1.0f, a.m_data, a.m_ld,
+          b.m_data, b.m_ld,
+          0.0f, result.m_data, result.m_ld);
+
+}
+
+// Same as productNT but written into result
+template <typename T>
+void BasicMatrix<T>::productNTInto (const View& a, const View& b, BasicMatrix& result){
+
+    // Ensure Matrix Multiplication can be applied
+    // - Columns of 'a' must equal columns of 'b'
+    if(a.m_cols != b.m_cols){
+        printf ("matrices cannot be multiplied\n");
+        printf ("columns of a must equal columns of b\n");
+        printf ("a: %lux%lu\n", a.m_rows, a.m_cols);
+        printf ("b: %lux%lu\n", b.m_rows, b.m_cols);
+        result = BasicMatrix();
+        return;
     }
+
+    // - with rows of 'a' and rows of 'b'
+    result.resize (a.m_rows, b.m_rows);
+
+    gemm (false, true, a.m_rows, b.m_rows, a.m_cols,
+          1.0f, a.m_data, a.m_ld,
+          b.m_data, b.m_ld,
+          0.0f, result.m_data, result.m_ld);
+
 }
 
 // Returns given matrix transposed
 // -Rows become columns 
 // -Columns become rows
-Matrix Matrix::transpose(Matrix m){
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::transpose(const View& m){
     
     // Create new transposed matrix
-    Matrix transposedMatrix (m.m_cols, m.m_rows);
+    BasicMatrix transposedMatrix;
+    transposedMatrix.resize (m.m_cols, m.m_rows);
+    size_t ld = transposedMatrix.m_ld;
 
     // Transpose Data
     for(size_t i = 0; i < m.m_rows; i++){
         for(size_t j = 0; j < m.m_cols; j++){
-            transposedMatrix.m_data[j*m.m_rows+i] = m.m_data[i*m.m_cols+j];
+            transposedMatrix.m_data[j*ld+i] = m.m_data[i*m.m_ld+j];
         }
     }
 
@@ -442,33 +914,16 @@ Matrix Matrix::transpose(Matrix m){
 
 }
 
-// Applies a given function to elements of a given matrix
-// returns a new matrix of the application
-// Note: original matrix is unnaffected
-Matrix Matrix::map (Matrix m, float (*fn)(float)){
-
-    Matrix matrix (m.m_rows, m.m_cols);
-
-    for(size_t i = 0; i < m.m_rows; i++) {
-        for(size_t j = 0; j < m.m_cols; j++){
-            // pass through function
-            matrix.m_data[i*matrix.m_cols+j] = fn(m.m_data[i*m.m_cols+j]);
-        }
-    }
-
-    return matrix;
-
-}
-
 // PRINTING 
 // ================================================================
 
 // Prints the matrix in a row/column format
-void Matrix::print() 
+template <typename T>
+void BasicMatrix<T>::print() const
 {
     for (size_t i = 0; i < m_rows; i++) {
         for (size_t j = 0; j < m_cols; j++) {
-            printf ("% 8.2f ", m_data[i*m_cols+j]);
+            printf ("% 8.2f ", (double) Scalar (m_data[i*m_ld+j]));
         }
         printf ("\n");
     }
@@ -476,6 +931,13 @@ void Matrix::print()
 
 // ================================================================
 
+// Element types the library is built for
+template class BasicMatrix<float>;
+template class BasicMatrix<double>;
+template class BasicMatrix<bfloat16>;
+
+// ================================================================
+
 
 /*
  Matrix m (3, 5);
@@ -11,79 +11,254 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <cstring> // memcpy 
+#include "element.hpp"
 
 //========================================================================
 
 const int SINGLE_ROW = 1;
 const int SINGLE_COLUMN = 0;
 
+// Byte alignment of matrix buffers and of the rows of owned matrices
+const size_t MATRIX_ALIGNMENT = 64;
+
+// Lazy elementwise expressions (see matrix_expr.hpp)
+template <typename E> struct MatrixExpr;
+
+template <typename T> class BasicMatrix;
+
 //========================================================================
 
-class Matrix 
+// Read-only view of rows x cols elements in someone else's memory
+// - element (i, j) is m_data[i*m_ld+j], rows are m_ld elements apart
+// - a matrix converts to a view of all of it, and the row, column and
+//   block ranges of a view are views of the same memory, so a slice of
+//   a large buffer (e.g. a dataset) is read in place, without a copy
+// - the memory must outlive the view
+template <typename T>
+class BasicMatrixView
 {
 
 public:
     // Members
-    float* m_data;
+    const T* m_data;
+    size_t m_rows;
+    size_t m_cols;
+    // leading dimension (elements from one row to the next, >= m_cols)
+    size_t m_ld;
+
+    BasicMatrixView () : m_data (nullptr), m_rows (0), m_cols (0), m_ld (0) {}
+
+    // Views rows x cols elements with rows ld apart (tightly packed
+    // rows by default)
+    BasicMatrixView (const T* data, size_t rows, size_t cols, size_t ld = 0)
+        : m_data (data), m_rows (rows), m_cols (cols), m_ld (ld ? ld : cols) {}
+
+    // Views all of a matrix
+    BasicMatrixView (const BasicMatrix<T>& matrix);
+
+    // Returns element (i, j)
+    const T& at(size_t i, size_t j) const { return m_data[i*m_ld+j]; }
+
+    // Tells if the elements are one flat array (no gaps between rows)
+    bool contiguous() const { return m_ld == m_cols || m_rows <= 1; }
+
+    // Returns count rows starting at row first
+    BasicMatrixView rows(size_t first, size_t count) const {
+        return block(first, 0, count, m_cols);
+    }
+
+    // Returns count columns starting at column first
+    BasicMatrixView cols(size_t first, size_t count) const {
+        return block(0, first, m_rows, count);
+    }
+
+    // Returns row i (1 x cols) or column j (rows x 1)
+    BasicMatrixView row(size_t i) const { return rows(i, 1); }
+    BasicMatrixView col(size_t j) const { return cols(j, 1); }
+
+    // Returns the rows x cols block starting at element (row, col)
+    // (an empty view if it does not fit in this one)
+    BasicMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const {
+        if(row + rows > m_rows || col + cols > m_cols){
+            printf("error: block %lux%lu at (%lu, %lu) is outside of a %lux%lu view\n",
+                rows, cols, row, col, m_rows, m_cols);
+            return BasicMatrixView();
+        }
+        return BasicMatrixView(m_data + row*m_ld + col, rows, cols, m_ld);
+    }
+
+};
+
+//========================================================================
+
+// Matrix of elements of type T (float, double or bfloat16)
+// - arithmetic and scalars use the accumulator type of T (Scalar)
+// - Matrix is the float instantiation, used throughout the library
+// - row-major, element (i, j) is m_data[i*m_ld+j]: the buffers a matrix
+//   owns start on a MATRIX_ALIGNMENT boundary and their rows are padded
+//   to whole multiples of it (vectors are not padded), so every row
+//   starts aligned; matrices over external memory are tightly packed
+//   unless given a row stride
+template <typename T>
+class BasicMatrix 
+{
+
+public:
+    // type scalars are given in and arithmetic is done in
+    typedef typename Accumulator<T>::type Scalar;
+    // operands are read through views, so a matrix or a slice of one
+    // (or of any other memory) can be passed
+    typedef BasicMatrixView<T> View;
+
+    // Members
+    T* m_data;
     size_t m_rows;
     size_t m_cols; 
+    // leading dimension (elements from one row to the next, >= m_cols)
+    size_t m_ld;
+    // number of elements m_data has room for (>= m_rows*m_ld)
+    size_t m_capacity;
+    // false when m_data is external memory (not freed by this matrix)
+    bool m_owner;
 
 
     // ================================================================
 
-    Matrix ();
+    BasicMatrix ();
     // Ctor 
     // Constructs a blank (zero-valued) matrix 
     // with given dimensions
-    Matrix (size_t rows, size_t cols);
+    // (large buffers come straight from the OS already zeroed, their
+    // pages are only touched when first written)
+    BasicMatrix (size_t rows, size_t cols);
+
+    // Constructs a matrix over existing memory (e.g. a Workspace)
+    // - data must hold rows*ld elements and outlive the matrix
+    // - rows are ld elements apart (tightly packed by default)
+    // - the data is not initialized and is never freed by the matrix
+    // - if the matrix is later resized beyond its memory it moves to
+    //   its own buffer
+    BasicMatrix (size_t rows, size_t cols, T* data, size_t ld = 0);
+
+    // Constructs a matrix holding a (tightly packed) copy of a view
+    explicit BasicMatrix (const View& view);
+
+    // A matrix owns its data
+    // - copies are deep, copy assignment reuses this matrix's buffer
+    //   when it is big enough
+    // - moves steal the buffer and leave the source empty
+    BasicMatrix (const BasicMatrix& other);
+    BasicMatrix (BasicMatrix&& other) noexcept;
+    BasicMatrix& operator= (const BasicMatrix& other);
+    BasicMatrix& operator= (BasicMatrix&& other) noexcept;
+    ~BasicMatrix ();
+
+    // Evaluates an elementwise expression in a single fused pass
+    // (defined in matrix_expr.hpp)
+    template <typename E> BasicMatrix (const MatrixExpr<E>& expr);
+    template <typename E> BasicMatrix& operator= (const MatrixExpr<E>& expr);
 
     // DATA 
     // ================================================================
 
-    // data should contain rows*cols # of data 
-    void setData(float* data);
+    // Copies rows*cols # of data into this matrix
+    void setData(const T* data);
+
+    // Changes the dimensions of this matrix 
+    // the buffer is only reallocated if it is too small 
+    // (rows are padded whenever the memory has room for it, so external
+    // memory laid out with paddedStride stays padded)
+    // Note: contents are unspecified afterwards
+    void resize(size_t rows, size_t cols);
+
+    // Tells if the elements are one flat array (no padding between rows)
+    bool contiguous() const { return m_ld == m_cols || m_rows <= 1; }
+
+    // Returns the row stride an owned rows x cols matrix is stored with
+    // (vectors are not padded), to lay out external memory the same way
+    static size_t paddedStride(size_t rows, size_t cols);
 
     // Randomly generates data 
     void randomize();
 
     // Returns a copy of this matrix 
-    Matrix copy();
+    BasicMatrix copy() const;
 
     // Returns this matrix transposed
     // -Rows become columns 
     // -Columns become rows
-    Matrix transpose();
+    BasicMatrix transpose() const;
 
     // Converts this matrix to an array if there is only one column or one row
-    float* toArray();
+    // Note: the array is malloc'd and must be freed by the caller
+    T* toArray() const;
 
     // Converts and returns an array into a matrix 
     // the array is converted from a single row to a single column by default
     // use Const SINGLE_ROW/SINGLE_COLUMN
-    static Matrix fromArray(float* arr, int n, int type);
+    static BasicMatrix fromArray(const T* arr, int n, int type);
 
     // MATRIX MATH 
     // ================================================================
 
     // Adds a scalar or another matrix to this matrix 
     // Note: this matrix is affected while the other is not
-    void add(float n);
-    void add(Matrix n);
+    void add(Scalar n);
+    void add(const View& n);
 
     // Subtracts a scalar or another matrix to this matrix 
     // Note: this matrix is affected while the other is not
-    void subtract(float n);
-    void subtract(Matrix n);
+    void subtract(Scalar n);
+    void subtract(const View& n);
 
     // Multiplies this matrix by a scalar value or another matrixv
-    void multiply(float n);
-    void multiply(Matrix n);
+    void multiply(Scalar n);
+    void multiply(const View& n);
+
+    // Adds a scaled matrix to this matrix (this += alpha * x)
+    void addScaled(Scalar alpha, const View& x);
+
+    // Adds a scaled outer product to this matrix (this += alpha * x * y^T)
+    // x and y must be vectors (one row or one column) with
+    // as many elements as this matrix has rows and columns respectively
+    // Note: updated in place in one pass, the outer product is not formed
+    void addOuterProduct(Scalar alpha, const View& x, const View& y);
+
+    // Adds a scaled matrix product to this matrix
+    // addProduct: this += alpha * a * b
+    // addProductNT: this += alpha * a * b^T (b is read in place, no
+    // transposed copy is made)
+    void addProduct(Scalar alpha, const View& a, const View& b);
+    void addProductNT(Scalar alpha, const View& a, const View& b);
+
+    // Adds a column vector to every column of this matrix 
+    // v must be rows x 1
+    void addColumnVector(const View& v);
+
+    // Adds the scaled sum of the columns of m to this column vector
+    // (this += alpha * m * ones) 
+    // this must be m.rows x 1
+    void addScaledRowSums(Scalar alpha, const View& m);
 
     // Tests if a given matrix equals this matrix
-    bool equals(Matrix m);
+    bool equals(const View& m) const;
 
     // Applies a given function to each element of this matrix
-    void map(float (*f)(float));
+    // fn can be a function pointer, lambda or functor taking a Scalar
+    // (it is a template so the call can be inlined into the loop)
+    template <typename F>
+    void map(F fn){
+        // pass each element through function
+        // (a single flat loop when there is no padding between rows)
+        size_t rows = contiguous() ? 1 : m_rows;
+        size_t cols = contiguous() ? m_rows*m_cols : m_cols;
+        for(size_t i = 0; i < rows; i++) {
+            T* row = m_data + i*m_ld;
+            for(size_t j = 0; j < cols; j++) {
+                row[j] = T (fn(Scalar (row[j])));
+            }
+        }
+    }
 
     // STATIC METHODS: MATH 
     // ================================================================
@@ -91,47 +266,82 @@ public:
     // Adds a scalar to a matrix or adds two matrices together elementwise
     // note: none of the matrices are altered 
     // the result is return as a new matrix
-    static Matrix add(float a, Matrix b);
-    static Matrix add(Matrix a, float b);
-    static Matrix add(Matrix a, Matrix b);
+    static BasicMatrix add(Scalar a, const View& b);
+    static BasicMatrix add(const View& a, Scalar b);
+    static BasicMatrix add(const View& a, const View& b);
 
     // Subtract a scalar to a matrix or Subtracts two matrices together elementwise
     // note: none of the matrices are altered 
     // the result is return as a new matrix
-    static Matrix subtract(float a, Matrix b);
-    static Matrix subtract(Matrix a, float b);
-    static Matrix subtract(Matrix a, Matrix b);
+    static BasicMatrix subtract(Scalar a, const View& b);
+    static BasicMatrix subtract(const View& a, Scalar b);
+    static BasicMatrix subtract(const View& a, const View& b);
 
     // Multiplies a matrix by a scalar value or another matrix
     // uses hadamard product (element-wise)
     // returns the new matrix 
-    static Matrix multiply(float a, Matrix b);
-    static Matrix multiply(Matrix a, float b);
-    static Matrix multiply(Matrix a, Matrix b);
+    static BasicMatrix multiply(Scalar a, const View& b);
+    static BasicMatrix multiply(const View& a, Scalar b);
+    static BasicMatrix multiply(const View& a, const View& b);
 
     // Multiplies two given matrices together 
     // Using the matrix product method
-    static Matrix product(Matrix a, Matrix b);
+    // (sums in the accumulator type, see gemm.hpp)
+    static BasicMatrix product(const View& a, const View& b);
+
+    // Matrix product with one operand read as transposed (in place)
+    // productTN returns a^T * b
+    // productNT returns a * b^T
+    static BasicMatrix productTN(const View& a, const View& b);
+    static BasicMatrix productNT(const View& a, const View& b);
+
+    // Same as product/productTN/productNT but written into result
+    // result is resized if needed and must not be a or b
+    static void productInto(const View& a, const View& b, BasicMatrix& result);
+    static void productTNInto(const View& a, const View& b, BasicMatrix& result);
+    static void productNTInto(const View& a, const View& b, BasicMatrix& result);
 
     // Returns given matrix transposed
     // -Rows become columns 
     // -Columns become rows
-    static Matrix transpose(Matrix m);
+    static BasicMatrix transpose(const View& m);
 
     // Applies a given function to elements of a given matrix
     // returns a new matrix of the application
     // Note: original matrix is unnaffected
-    static Matrix map(Matrix m, float (*fn)(float));
+    template <typename F>
+    static BasicMatrix map(const View& m, F fn){
+        BasicMatrix matrix;
+        matrix.resize(m.m_rows, m.m_cols);
+        for(size_t i = 0; i < m.m_rows; i++) {
+            for(size_t j = 0; j < m.m_cols; j++) {
+                matrix.m_data[i*matrix.m_ld+j] = T (fn(Scalar (m.m_data[i*m.m_ld+j])));
+            }
+        }
+        return matrix;
+    }
 
     // PRINTING 
     // ================================================================
 
     // Prints the matrix in a row/column format
-    void print();
+    void print() const;
 
 
 };
 
+// Views all of a matrix
+template <typename T>
+inline BasicMatrixView<T>::BasicMatrixView (const BasicMatrix<T>& matrix)
+    : m_data (matrix.m_data), m_rows (matrix.m_rows), m_cols (matrix.m_cols), m_ld (matrix.m_ld) {}
+
+// Element types (defined in matrix.cpp)
+typedef BasicMatrix<float> Matrix;
+typedef BasicMatrix<double> MatrixDouble;
+typedef BasicMatrix<bfloat16> MatrixBF16;
+typedef BasicMatrixView<float> MatrixView;
+typedef BasicMatrixView<double> MatrixViewDouble;
+typedef BasicMatrixView<bfloat16> MatrixViewBF16;
 
 //========================================================================
 
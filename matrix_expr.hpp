@@ -0,0 +1,257 @@
+// Matrix Expression Templates
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Elementwise arithmetic on matrices builds a lazy expression tree
+// instead of a new matrix per step. The tree is evaluated in a single
+// fused loop when it is assigned to (or used to construct) a Matrix:
+//
+//     errors    = answers - outputs;
+//     gradients = errors * map (outputs, dsigmoid);
+//     hidden    = map (hidden + bias, sigmoid);
+//
+// - '*' is the elementwise (hadamard) product, like Matrix::multiply
+//   (use Matrix::product for the matrix product)
+// - each element is computed with the same float operations, in the
+//   same order, as the equivalent chain of Matrix calls, so results are
+//   bit-identical (as long as the compiler is not allowed to contract
+//   a*b+c into a fused multiply-add)
+// - the target may appear in its own expression, element (i, j) is
+//   only ever computed from element (i, j) of each operand
+// - elements are read as the matrix's Scalar (accumulator) type and
+//   the result is rounded to the target's element type once
+//
+//========================================================================
+
+#ifndef MATRIX_EXPR_HPP
+#define MATRIX_EXPR_HPP
+
+//========================================================================
+
+#include <type_traits>
+#include <utility> // declval
+#include "matrix.hpp"
+
+//========================================================================
+
+// Base of every expression node (CRTP)
+// nodes provide:
+// - rows(), cols()  dimensions of the result
+// - at(i, j)        element (i, j) of the result (when every matrix
+//                   in the tree has no padding between rows, at(0, j)
+//                   is element j of the flattened result)
+// - contiguous()    false if any matrix has padding between rows
+// - valid()         false if any operands have mismatched dimensions
+// - isScalar        true for scalar leaves (which take any shape)
+// - value_type      the type at() returns
+template <typename E>
+struct MatrixExpr
+{
+    const E& self () const { return static_cast<const E&> (*this); }
+};
+
+//========================================================================
+// LEAVES
+
+// Refers to an existing matrix (not copied)
+template <typename T>
+struct MatrixRef : MatrixExpr<MatrixRef<T> >
+{
+    typedef typename BasicMatrix<T>::Scalar value_type;
+    static const bool isScalar = false;
+    const BasicMatrix<T>& m_matrix;
+
+    MatrixRef (const BasicMatrix<T>& matrix) : m_matrix (matrix) {}
+
+    size_t rows () const { return m_matrix.m_rows; }
+    size_t cols () const { return m_matrix.m_cols; }
+    bool valid () const { return true; }
+    bool contiguous () const { return m_matrix.contiguous (); }
+    value_type at (size_t i, size_t j) const { return value_type (m_matrix.m_data[i*m_matrix.m_ld+j]); }
+};
+
+// A scalar broadcast to every element
+template <typename S>
+struct ScalarExpr : MatrixExpr<ScalarExpr<S> >
+{
+    typedef S value_type;
+    static const bool isScalar = true;
+    S m_value;
+
+    ScalarExpr (S value) : m_value (value) {}
+
+    size_t rows () const { return 0; }
+    size_t cols () const { return 0; }
+    bool valid () const { return true; }
+    bool contiguous () const { return true; }
+    S at (size_t, size_t) const { return m_value; }
+};
+
+//========================================================================
+// NODES
+
+struct ExprAdd      { template <typename A, typename B> static auto apply (A a, B b) -> decltype (a + b) { return a + b; } };
+struct ExprSubtract { template <typename A, typename B> static auto apply (A a, B b) -> decltype (a - b) { return a - b; } };
+struct ExprMultiply { template <typename A, typename B> static auto apply (A a, B b) -> decltype (a * b) { return a * b; } };
+
+// Elementwise binary operation
+// operands are stored by value (nodes are small, leaves hold references)
+template <typename L, typename R, typename Op>
+struct BinaryExpr : MatrixExpr<BinaryExpr<L, R, Op> >
+{
+    typedef decltype (Op::apply (typename L::value_type (), typename R::value_type ())) value_type;
+    static const bool isScalar = L::isScalar && R::isScalar;
+    L m_left;
+    R m_right;
+
+    BinaryExpr (const L& left, const R& right) : m_left (left), m_right (right) {}
+
+    size_t rows () const { return L::isScalar ? m_right.rows () : m_left.rows (); }
+    size_t cols () const { return L::isScalar ? m_right.cols () : m_left.cols (); }
+
+    bool valid () const
+    {
+        if (!m_left.valid () || !m_right.valid ()) return false;
+        if (L::isScalar || R::isScalar) return true;
+        return m_left.rows () == m_right.rows () && m_left.cols () == m_right.cols ();
+    }
+
+    bool contiguous () const { return m_left.contiguous () && m_right.contiguous (); }
+    value_type at (size_t i, size_t j) const { return Op::apply (m_left.at (i, j), m_right.at (i, j)); }
+};
+
+// Applies a function to each element
+// F can be a function pointer or any callable taking an element
+template <typename E, typename F>
+struct MapExpr : MatrixExpr<MapExpr<E, F> >
+{
+    typedef decltype (std::declval<F> () (typename E::value_type ())) value_type;
+    static const bool isScalar = E::isScalar;
+    E m_expr;
+    F m_fn;
+
+    MapExpr (const E& expr, F fn) : m_expr (expr), m_fn (fn) {}
+
+    size_t rows () const { return m_expr.rows (); }
+    size_t cols () const { return m_expr.cols (); }
+    bool valid () const { return m_expr.valid (); }
+    bool contiguous () const { return m_expr.contiguous (); }
+    value_type at (size_t i, size_t j) const { return m_fn (m_expr.at (i, j)); }
+};
+
+//========================================================================
+// OPERANDS
+
+// Maps an operand type to the node that represents it in a tree
+// - a matrix becomes a MatrixRef
+// - an expression is stored as itself
+// - anything else is not an operand (so the operators below do not apply)
+template <typename A, typename Enable = void>
+struct ExprOperand {};
+
+template <typename T>
+struct ExprOperand<BasicMatrix<T> >
+{
+    typedef MatrixRef<T> type;
+};
+
+template <typename A>
+struct ExprOperand<A, typename std::enable_if<std::is_base_of<MatrixExpr<A>, A>::value>::type>
+{
+    typedef A type;
+};
+
+//========================================================================
+// OPERATORS
+// scalars are converted to the value type of the other operand
+// (so a float matrix times a double literal still computes in float)
+
+#define MATRIX_EXPR_OPERATOR(OP, NODE)                                                          \
+    template <typename A, typename B>                                                           \
+    BinaryExpr<typename ExprOperand<A>::type, typename ExprOperand<B>::type, NODE>              \
+    operator OP (const A& a, const B& b)                                                        \
+    {                                                                                           \
+        return BinaryExpr<typename ExprOperand<A>::type, typename ExprOperand<B>::type, NODE>   \
+            (typename ExprOperand<A>::type (a), typename ExprOperand<B>::type (b));            \
+    }                                                                                           \
+    template <typename A, typename S = typename ExprOperand<A>::type::value_type>                \
+    BinaryExpr<typename ExprOperand<A>::type, ScalarExpr<S>, NODE>                              \
+    operator OP (const A& a, typename std::common_type<S>::type b)                              \
+    {                                                                                           \
+        return BinaryExpr<typename ExprOperand<A>::type, ScalarExpr<S>, NODE>                   \
+            (typename ExprOperand<A>::type (a), ScalarExpr<S> (b));                            \
+    }                                                                                           \
+    template <typename B, typename S = typename ExprOperand<B>::type::value_type>                \
+    BinaryExpr<ScalarExpr<S>, typename ExprOperand<B>::type, NODE>                              \
+    operator OP (typename std::common_type<S>::type a, const B& b)                              \
+    {                                                                                           \
+        return BinaryExpr<ScalarExpr<S>, typename ExprOperand<B>::type, NODE>                   \
+            (ScalarExpr<S> (a), typename ExprOperand<B>::type (b));                            \
+    }
+
+// elementwise a + b, a - b and a * b (hadamard)
+MATRIX_EXPR_OPERATOR (+, ExprAdd)
+MATRIX_EXPR_OPERATOR (-, ExprSubtract)
+MATRIX_EXPR_OPERATOR (*, ExprMultiply)
+
+#undef MATRIX_EXPR_OPERATOR
+
+// Lazily applies fn to each element of a matrix or expression
+template <typename A, typename F>
+MapExpr<typename ExprOperand<A>::type, F> map (const A& a, F fn)
+{
+    return MapExpr<typename ExprOperand<A>::type, F> (typename ExprOperand<A>::type (a), fn);
+}
+
+//========================================================================
+// EVALUATION
+
+// Constructs a matrix from an expression
+template <typename T>
+template <typename E>
+BasicMatrix<T>::BasicMatrix (const MatrixExpr<E>& expr)
+    : BasicMatrix ()
+{
+    *this = expr;
+}
+
+// Evaluates an expression into this matrix in one pass
+// this matrix is resized if needed (reusing its buffer when possible)
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator= (const MatrixExpr<E>& expr)
+{
+    const E& e = expr.self ();
+
+    // Ensure operands have matching dimensions
+    if (!e.valid ()) {
+        printf ("error: matrices must have the same dimensions\n");
+        printf ("to preform elementwise operation\n");
+        return *this;
+    }
+
+    // resizing never reallocates when this matrix is an operand
+    // (it already has the right size)
+    resize (e.rows (), e.cols ());
+
+    // one flat loop unless some matrix has padding between rows
+    T* data = m_data;
+    if (contiguous () && e.contiguous ()) {
+        size_t size = m_rows * m_cols;
+        for (size_t j = 0; j < size; j++) {
+            data[j] = T (e.at (0, j));
+        }
+        return *this;
+    }
+    for (size_t i = 0; i < m_rows; i++) {
+        for (size_t j = 0; j < m_cols; j++) {
+            data[i*m_ld+j] = T (e.at (i, j));
+        }
+    }
+    return *this;
+}
+
+//========================================================================
+
+#endif
@@ -0,0 +1,105 @@
+// Binary Model File Format
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "modelfile.hpp"
+
+//========================================================================
+
+// Returns the checksum of size bytes (FNV-1a over 64 bit words)
+uint64_t modelChecksum (const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*) data;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy (&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+//========================================================================
+
+MappedFile::MappedFile ()
+{
+    m_data = nullptr;
+    m_size = 0;
+}
+
+MappedFile::~MappedFile ()
+{
+    close ();
+}
+
+MappedFile::MappedFile (MappedFile&& other) noexcept
+{
+    m_data = other.m_data;
+    m_size = other.m_size;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        close ();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+//========================================================================
+
+// Maps the file at path, copy-on-write
+bool MappedFile::open (const char* path)
+{
+    close ();
+
+    int fd = ::open (path, O_RDONLY);
+    if (fd < 0) {
+        printf ("error: could not open %s\n", path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat (fd, &info) != 0 || info.st_size == 0) {
+        printf ("error: could not read the size of %s\n", path);
+        ::close (fd);
+        return false;
+    }
+
+    void* data = mmap (nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close (fd);
+    if (data == MAP_FAILED) {
+        printf ("error: could not map %s\n", path);
+        return false;
+    }
+
+    m_data = (unsigned char*) data;
+    m_size = info.st_size;
+    return true;
+}
+
+// Unmaps the file
+void MappedFile::close ()
+{
+    if (m_data) {
+        munmap (m_data, m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+//========================================================================
@@ -0,0 +1,108 @@
+// Binary Model File Format
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// A saved network is one file:
+//
+//     ModelHeader                 64 bytes
+//     layer sizes                 m_layerCount uint64_t, inputs first
+//     zero padding                up to m_dataOffset
+//     parameters                  m_dataSize bytes
+//
+// The parameters are laid out exactly like a network's m_parameters
+// block: layer by layer, the weights (row-major, each row zero padded to
+// a multiple of m_alignment bytes unless the layer has a single row or
+// column) then the bias, each blob zero padded to a multiple of
+// m_alignment bytes. m_dataOffset is a
+// multiple of m_alignment too, so once the file is mapped into memory
+// every blob can be used in place as a matrix.
+//
+// Values are stored in the byte order of the machine that saved them
+// (little endian on everything this builds for).
+//
+//========================================================================
+
+#ifndef MODELFILE_HPP
+#define MODELFILE_HPP
+
+//========================================================================
+
+#include <stdint.h>
+#include <stdlib.h>
+
+//========================================================================
+
+// first bytes of every model file
+#define MODEL_MAGIC "SNNMODEL"
+
+// bumped whenever the layout changes (files of other versions are rejected)
+// (2: padded weight rows)
+const uint32_t MODEL_VERSION = 2;
+
+// Element type of the parameters
+enum ModelDtype
+{
+    MODEL_FLOAT32 = 1,
+    MODEL_FLOAT64 = 2
+};
+
+// ModelHeader::m_flags
+const uint32_t MODEL_FAST_ACTIVATION = 1;
+
+struct ModelHeader
+{
+    char     m_magic[8];
+    uint32_t m_version;
+    // ModelDtype
+    uint32_t m_dtype;
+    // of the parameter blobs, in bytes
+    uint32_t m_alignment;
+    uint32_t m_flags;
+    // number of layers, including the inputs
+    uint64_t m_layerCount;
+    // bytes from the start of the file to the parameters
+    uint64_t m_dataOffset;
+    uint64_t m_dataSize;
+    // modelChecksum of the parameters (padding included)
+    uint64_t m_checksum;
+    double   m_learningRate;
+};
+
+// Returns the checksum of size bytes (a multiple of 8)
+// FNV-1a over 64 bit words
+uint64_t modelChecksum (const void* data, size_t size);
+
+//========================================================================
+
+// A whole file mapped into memory, copy-on-write (MAP_PRIVATE)
+// the pages can be written but the changes never reach the file
+// pages are read from disk on first touch, so opening does not depend
+// on the size of the file
+class MappedFile
+{
+
+public:
+    unsigned char* m_data;
+    size_t m_size;
+
+    MappedFile ();
+    ~MappedFile ();
+
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+    MappedFile (MappedFile&& other) noexcept;
+    MappedFile& operator= (MappedFile&& other) noexcept;
+
+    // Maps the file at path (replacing any current mapping)
+    // returns false (and prints why) if it cannot
+    bool open (const char* path);
+
+    // Unmaps the file
+    void close ();
+
+};
+
+//========================================================================
+
+#endif
@@ -4,66 +4,452 @@
 //========================================================================
 
 #include <math.h> 
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include "matrix.hpp"
+#include "matrix_expr.hpp"
 #include "neuralnet.hpp"
+#include "optimizer.hpp"
+#include "profile.hpp"
+#include "simd.hpp"
 
 //========================================================================
 
-const double EULER = 2.71828182845904523536;
-
 // ACTIVATION FUNCTION
 // sigmoid:
 // 1 / (1 + e^-x)
+// (the network applies it with the vectorized simd().sigmoid kernels,
+// this scalar version is the reference they are checked against)
 float sigmoid(float x){
-    return (1) / (1 + pow (EULER, -x));
+    return 1.0f / (1.0f + expf (-x));
+}
+double sigmoid(double x){
+    return 1.0 / (1.0 + exp (-x));
 }
 
 // derivative of sigmoid 
 // this is not the full derivative because 
 // it is used after sigmoid is already applied
 // dsigmoid(x) = sigmoid(x) / (1 - sigmoid(x));
-float dsigmoid(float x){
+template <typename S>
+S dsigmoid(S x){
     return (x * (1 - x));
 }
 
+// Adds the bias to each column of nodes and applies sigmoid in place
+// fast selects the cheaper (less accurate) exp approximation
+static void activate(Matrix& nodes, const Matrix& bias, bool fast){
+    nodes.addColumnVector(bias);
+    // one flat pass unless the rows are padded
+    size_t rows = nodes.contiguous() ? 1 : nodes.m_rows;
+    size_t size = nodes.contiguous() ? nodes.m_rows*nodes.m_cols : nodes.m_cols;
+    for(size_t i = 0; i < rows; i++){
+        float* row = nodes.m_data + i*nodes.m_ld;
+        if (fast)
+            simd().sigmoidFast(row, row, size);
+        else
+            simd().sigmoid(row, row, size);
+    }
+}
+
+// other element types use the scalar sigmoid (there is no fast mode)
+template <typename T>
+static void activate(BasicMatrix<T>& nodes, const BasicMatrix<T>& bias, bool){
+    typedef typename BasicMatrix<T>::Scalar Scalar;
+    nodes.addColumnVector(bias);
+    nodes.map([] (Scalar x) { return sigmoid(x); });
+}
+
+// WORK ESTIMATES (for the profiler)
+// a product reads both operands and writes the result once
+template <typename M>
+static inline uint64_t elements(const M& m){
+    return uint64_t(m.m_rows) * m.m_cols;
+}
+template <typename M>
+static inline uint64_t bytes(const M& m){
+    return elements(m) * sizeof(*m.m_data);
+}
+template <typename M>
+static inline uint64_t productFlops(const M& a, const M& b){
+    return 2 * elements(a) * b.m_cols;
+}
+template <typename M>
+static inline uint64_t productBytes(const M& a, const M& b){
+    return bytes(a) + bytes(b) + a.m_rows * b.m_cols * sizeof(*a.m_data);
+}
+
+// Returns the elements of T that count elements take up in a block of
+// matrices (rounded up so the next matrix starts on a cache line)
+template <typename T>
+static inline size_t blockElements(size_t count){
+    return Workspace::footprint(count, sizeof(T)) * sizeof(float) / sizeof(T);
+}
+
+// Adds the block elements of a rows x cols matrix (rows padded, see
+// BasicMatrix::paddedStride) to size
+// returns false if they or the sum do not fit in a size_t
+template <typename T>
+static bool addBlockElements(size_t rows, size_t cols, size_t& size){
+    // (the stride and footprint round up, which must not wrap either)
+    const size_t limit = SIZE_MAX / sizeof(T) - WORKSPACE_ALIGNMENT;
+    if(cols > limit){
+        return false;
+    }
+    size_t ld = BasicMatrix<T>::paddedStride(rows, cols);
+    if(ld != 0 && rows > limit / ld){
+        return false;
+    }
+    size_t count = blockElements<T>(rows * ld);
+    if(count > SIZE_MAX - size){
+        return false;
+    }
+    size += count;
+    return true;
+}
+
+// INPUTS OF THE FIRST LAYER
+// node values of the layer before (a Matrix, one sample per column),
+// samples in the rows of a view or sparse samples (rows of a
+// SparseMatrix), read in place either way
+
+// Rows [m_first, m_first + m_cols) of a sparse matrix as a batch of
+// input columns
+template <typename T>
+struct SparseBatch
+{
+    const BasicSparseMatrix<T>* m_samples;
+    size_t m_first;
+    size_t m_cols;
+};
+
+// Samples in the rows of a view (batch x inputCount, e.g. a slice of a
+// dataset) as a batch of input columns
+template <typename T>
+struct SampleRows
+{
+    BasicMatrixView<T> m_samples;
+};
+
+// Returns the nonzeros of the samples in a sparse batch
+template <typename T>
+static inline uint64_t nonZeros(const SparseBatch<T>& batch){
+    const std::vector<size_t>& start = batch.m_samples->m_rowStart;
+    return start[batch.m_first + batch.m_cols] - start[batch.m_first];
+}
+
+// Weighted sums of a layer: result = weights * inputs
+template <typename T>
+static void weightedSum(const BasicMatrix<T>& weights, const BasicMatrix<T>& inputs, BasicMatrix<T>& result){
+    NN_PROFILE_SCOPE(PROFILE_FORWARD_PRODUCT, productFlops(weights, inputs), productBytes(weights, inputs));
+    BasicMatrix<T>::productInto(weights, inputs, result);
+}
+template <typename T>
+static void weightedSum(const BasicMatrix<T>& weights, const SampleRows<T>& inputs, BasicMatrix<T>& result){
+    // weights * samples^T, the samples are read in place
+    const BasicMatrixView<T>& samples = inputs.m_samples;
+    NN_PROFILE_SCOPE(PROFILE_FORWARD_PRODUCT, 2 * elements(weights) * samples.m_rows,
+        bytes(weights) + bytes(samples) + weights.m_rows * samples.m_rows * sizeof(T));
+    BasicMatrix<T>::productNTInto(weights, samples, result);
+}
+template <typename T>
+static void weightedSum(const BasicMatrix<T>& weights, const SparseBatch<T>& inputs, BasicMatrix<T>& result){
+    // every nonzero reads a weight, a value and a column per node
+    NN_PROFILE_SCOPE(PROFILE_FORWARD_PRODUCT, 2 * weights.m_rows * nonZeros(inputs),
+        (weights.m_rows + 1) * nonZeros(inputs) * (sizeof(T) + sizeof(uint32_t)) + bytes(result));
+    BasicSparseMatrix<T>::productNTInto(weights, *inputs.m_samples, result, inputs.m_first);
+}
+
+// Weight and bias update of a layer:
+// weights += rate * gradients * inputs^T (summed over the batch)
+// bias += rate * gradients (summed over the batch)
+// (a single dense sample is a rank-1 update in place)
+template <typename T, typename S>
+static void updateLayer(S rate, const BasicMatrix<T>& gradients, const BasicMatrix<T>& inputs, BasicMatrix<T>& weights, BasicMatrix<T>& bias){
+    size_t batchSize = gradients.m_cols;
+    NN_PROFILE_SCOPE(PROFILE_WEIGHT_UPDATE,
+        2 * (elements(weights) + elements(bias)) * batchSize,
+        2 * (bytes(weights) + bytes(bias)) + bytes(gradients) + bytes(inputs));
+    if(batchSize == 1){
+        weights.addOuterProduct(rate, gradients, inputs);
+        bias.addScaled(rate, gradients);
+    }
+    else {
+        weights.addProductNT(rate, gradients, inputs);
+        bias.addScaledRowSums(rate, gradients);
+    }
+}
+template <typename T, typename S>
+static void updateLayer(S rate, const BasicMatrix<T>& gradients, const SampleRows<T>& inputs, BasicMatrix<T>& weights, BasicMatrix<T>& bias){
+    // gradients * samples (the samples are rows, so no transpose)
+    NN_PROFILE_SCOPE(PROFILE_WEIGHT_UPDATE,
+        2 * (elements(weights) + elements(bias)) * gradients.m_cols,
+        2 * (bytes(weights) + bytes(bias)) + bytes(gradients) + bytes(inputs.m_samples));
+    weights.addProduct(rate, gradients, inputs.m_samples);
+    bias.addScaledRowSums(rate, gradients);
+}
+template <typename T, typename S>
+static void updateLayer(S rate, const BasicMatrix<T>& gradients, const SparseBatch<T>& inputs, BasicMatrix<T>& weights, BasicMatrix<T>& bias){
+    // only the weights of nonzero columns are read and written
+    NN_PROFILE_SCOPE(PROFILE_WEIGHT_UPDATE,
+        2 * (weights.m_rows * nonZeros(inputs) + elements(gradients)),
+        (2 * weights.m_rows + 1) * nonZeros(inputs) * sizeof(T) + 2 * bytes(bias) + bytes(gradients));
+    BasicSparseMatrix<T>::addProductNT(rate, gradients, *inputs.m_samples, weights, inputs.m_first);
+    bias.addScaledRowSums(rate, gradients);
+}
+
+//========================================================================
+
+// predictBatch runs at most this many samples through the network at once
+// (bounds the node memory a batch needs, however many samples there are)
+static const size_t PREDICT_BATCH = 64;
+
+// Copies the rows of samples (batchSize x count, one sample per row)
+// into the columns of a count x batchSize matrix
+template <typename T>
+static void packColumns(const BasicMatrixView<T>& samples, BasicMatrix<T>& packed){
+    size_t batchSize = samples.m_rows;
+    size_t count = samples.m_cols;
+    for(size_t b = 0; b < batchSize; b++){
+        for(size_t i = 0; i < count; i++){
+            packed.m_data[i*packed.m_ld+b] = samples.m_data[b*samples.m_ld+i];
+        }
+    }
+}
+
+// Copies the columns of a count x batchSize matrix out as batchSize
+// samples of count values (one sample after another)
+template <typename T>
+static void unpackColumns(const BasicMatrix<T>& packed, T* samples){
+    size_t count = packed.m_rows;
+    size_t batchSize = packed.m_cols;
+    for(size_t b = 0; b < batchSize; b++){
+        for(size_t i = 0; i < count; i++){
+            samples[b*count+i] = packed.m_data[i*packed.m_ld+b];
+        }
+    }
+}
+
 //========================================================================
 
 // Constructs the neural network
-// params - input, hidden, output
-NeuralNetwork::NeuralNetwork (size_t inputCount, size_t hiddenCount, size_t outputCount){
+// params - number of nodes per layer: input, hidden..., output
+template <typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork (const std::vector<size_t>& layerSizes){
 
-    m_inputCount = inputCount;
-    m_hiddenCount = hiddenCount;
-    m_outputCount = outputCount;
+    setLayerSizes(layerSizes);
 
-    // weights 
-    m_weights_ih = Matrix (hiddenCount, inputCount);
-    m_weights_ih.randomize();
-    m_weights_ho = Matrix (outputCount, hiddenCount);
-    m_weights_ho.randomize();
+    // one block for every weight and bias
+    // (cleared, so the padding at the ends of rows holds zeros)
+    m_parameters = Workspace (Workspace::footprint (parameterSize(), sizeof(T)));
+    memset(m_parameters.m_data, 0, m_parameters.m_capacity * sizeof(float));
+    bindParameters();
 
-    // bias
+    // weights then biases (layer by layer)
     // one bias for each layer
     // connected to each of the next layer
-    m_bias_ih = Matrix (hiddenCount, 1);
-    m_bias_ih.randomize();
-    m_bias_ho = Matrix (outputCount, 1);
-    m_bias_ho.randomize();
-    
-    // previous node values 
-    m_hidden_nodes;
-    m_output_nodes;
+    for(size_t l = 0; l < m_layers.size(); l++){
+        m_layers[l].m_weights.randomize();
+    }
+    for(size_t l = 0; l < m_layers.size(); l++){
+        m_layers[l].m_bias.randomize();
+    }
+
+}
+
+// Constructs an empty network (see setLayerSizes)
+template <typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork ()
+    : m_inputCount (0),
+      m_outputCount (0),
+      m_batchCapacity (0)
+{
+}
+
+// Sets the layer sizes and sizes the node values and scratch
+template <typename T>
+void BasicNeuralNetwork<T>::setLayerSizes (const std::vector<size_t>& layerSizes){
+
+    if(layerSizes.size() < 2){
+        printf("error: a network needs at least an input and an output layer\n");
+    }
+
+    m_layerSizes = layerSizes;
+    m_inputCount = layerSizes.empty() ? 0 : layerSizes.front();
+    m_outputCount = layerSizes.empty() ? 0 : layerSizes.back();
+    m_layers.resize(layerSizes.size() < 2 ? 0 : layerSizes.size() - 1);
+
+    // node values 
+    m_batchCapacity = 0;
+    reserveBatch(1);
+
+    // scratch for one step
+    m_workspace = Workspace (workspaceSize (1));
 
     m_learning_rate = 0.1;
 
 }
 
+// Constructs a network with a single hidden layer
+// params - input, hidden, output
+template <typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork (size_t inputCount, size_t hiddenCount, size_t outputCount)
+    : BasicNeuralNetwork (std::vector<size_t> {inputCount, hiddenCount, outputCount})
+{
+}
+
+// Copies are deep (layers are rebound to the copy's own memory)
+template <typename T>
+BasicNeuralNetwork<T>::BasicNeuralNetwork (const BasicNeuralNetwork& other)
+    : m_layerSizes (other.m_layerSizes),
+      m_inputCount (other.m_inputCount),
+      m_outputCount (other.m_outputCount),
+      m_layers (other.m_layers.size()),
+      m_batchCapacity (0),
+      m_workspace (other.m_workspace),
+      m_learning_rate (other.m_learning_rate),
+      m_fast_activation (other.m_fast_activation)
+{
+    // copied layer by layer (other's parameters may be shared)
+    // (assigning copies into the memory the layers are bound to)
+    m_parameters = Workspace (Workspace::footprint (parameterSize(), sizeof(T)));
+    memset(m_parameters.m_data, 0, m_parameters.m_capacity * sizeof(float));
+    bindParameters();
+    for(size_t l = 0; l < m_layers.size(); l++){
+        m_layers[l].m_weights = other.m_layers[l].m_weights;
+        m_layers[l].m_bias = other.m_layers[l].m_bias;
+    }
+    reserveBatch(1);
+}
+
+template <typename T>
+BasicNeuralNetwork<T>& BasicNeuralNetwork<T>::operator= (const BasicNeuralNetwork& other){
+    if(this != &other){
+        BasicNeuralNetwork copy (other);
+        m_layerSizes = copy.m_layerSizes;
+        m_inputCount = copy.m_inputCount;
+        m_outputCount = copy.m_outputCount;
+        m_layers = std::move (copy.m_layers);
+        m_parameters = std::move (copy.m_parameters);
+        m_mapping = std::move (copy.m_mapping);
+        m_activations = std::move (copy.m_activations);
+        m_batchCapacity = copy.m_batchCapacity;
+        m_workspace = std::move (copy.m_workspace);
+        m_learning_rate = copy.m_learning_rate;
+        m_fast_activation = copy.m_fast_activation;
+    }
+    return *this;
+}
+
+//========================================================================
+
+// Returns the workspace size (in floats) needed for a batch
+// - inputs
+// - errors of the current layer and of the layer before it when training,
+//   node values of the current layer and the one before it for inference
+//   (each sized for the largest layer)
+template <typename T>
+size_t BasicNeuralNetwork<T>::workspaceSize(size_t batchSize) const {
+    return Workspace::matrixFootprint<T> (m_inputCount, batchSize)
+         + Workspace::matrixFootprint<T> (largestLayer(), batchSize) * 2;
+}
+
+// Returns the number of nodes in the largest layer after the inputs
+template <typename T>
+size_t BasicNeuralNetwork<T>::largestLayer() const {
+    size_t largest = 0;
+    for(size_t l = 1; l < m_layerSizes.size(); l++){
+        if(m_layerSizes[l] > largest) largest = m_layerSizes[l];
+    }
+    return largest;
+}
+
+// Returns the size (in elements of T) of a block holding every weight and bias
+template <typename T>
+size_t BasicNeuralNetwork<T>::parameterSize() const {
+    size_t size = 0;
+    parameterSizeFor(m_layerSizes, size);
+    return size;
+}
+
+// Computes the size of a parameter block for layerSizes
+// (checked, so sizes read from a file can be rejected before use)
+template <typename T>
+bool BasicNeuralNetwork<T>::parameterSizeFor(const std::vector<size_t>& layerSizes, size_t& size){
+    size = 0;
+    for(size_t l = 0; l + 1 < layerSizes.size(); l++){
+        if(!addBlockElements<T>(layerSizes[l+1], layerSizes[l], size)
+           || !addBlockElements<T>(layerSizes[l+1], 1, size)){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Points the weights and biases of layers into block
+// layer by layer (weights then bias), each matrix starting on a cache line
+// and the weight rows padded to whole cache lines, like an owned matrix
+template <typename T>
+void BasicNeuralNetwork<T>::bindLayers(T* block, std::vector<Layer>& layers) const {
+    layers.resize(m_layers.size());
+    for(size_t l = 0; l < m_layers.size(); l++){
+        size_t ld = Matrix::paddedStride(m_layerSizes[l+1], m_layerSizes[l]);
+        layers[l].m_weights = Matrix(m_layerSizes[l+1], m_layerSizes[l], block, ld);
+        block += blockElements<T>(m_layerSizes[l+1] * ld);
+        layers[l].m_bias = Matrix(m_layerSizes[l+1], 1, block);
+        block += blockElements<T>(m_layerSizes[l+1]);
+    }
+}
+
+// Points every layer's weights and biases into m_parameters
+// (the workspace holds floats, the block is reinterpreted as T)
+template <typename T>
+void BasicNeuralNetwork<T>::bindParameters(){
+    bindLayers((T*) m_parameters.m_data, m_layers);
+}
+
+// Uses other's weights and biases instead of this network's own
+template <typename T>
+void BasicNeuralNetwork<T>::shareParameters(const BasicNeuralNetwork& other){
+    if(other.m_layerSizes != m_layerSizes){
+        printf("error: networks must have the same layer sizes to share parameters\n");
+        return;
+    }
+    if(m_layers.empty()){
+        return;
+    }
+    // the first layer's weights start the block
+    bindLayers(other.m_layers.front().m_weights.m_data, m_layers);
+    m_parameters = Workspace();
+}
+
+// Makes room for batchSize columns of node values in every layer
+template <typename T>
+void BasicNeuralNetwork<T>::reserveBatch(size_t batchSize){
+    if(batchSize <= m_batchCapacity){
+        return;
+    }
+
+    size_t size = 0;
+    for(size_t l = 0; l < m_layers.size(); l++){
+        size += Workspace::matrixFootprint<T> (m_layerSizes[l+1], batchSize);
+    }
+    m_activations.reserve(size);
+    m_activations.reset();
+    for(size_t l = 0; l < m_layers.size(); l++){
+        m_layers[l].m_nodes = m_activations.matrix<T>(m_layerSizes[l+1], batchSize);
+    }
+    m_batchCapacity = batchSize;
+}
+
 //========================================================================
 
 // Feed Forward Algorithm
 // Feeds input through neural network to arive at an output
 // param inputs - must be an array of desired inputs. (must be size of inputCount)
-float* NeuralNetwork::feedForward(float* inputsArr){
+template <typename T>
+T* BasicNeuralNetwork<T>::feedForward(const T* inputsArr) const {
 
     // Ensure inputs are valid 
     if(!inputsArr){
@@ -71,24 +457,258 @@ float* NeuralNetwork::feedForward(float* inputsArr){
         return nullptr;
     } 
 
+    T* output = (T*) malloc (m_outputCount * sizeof(T));
+    feedForwardInto(inputsArr, output);
+    return output;
+
+}
+
+// Returns the calling thread's inference scratch
+// (shared by every network the thread runs, grown to the largest)
+static Workspace& threadContext(){
+    static thread_local Workspace s_context;
+    return s_context;
+}
+
+// Feeds one sample through the network into a caller provided array
+template <typename T>
+void BasicNeuralNetwork<T>::feedForwardInto(const T* inputs, T* outputs) const {
+    feedForwardInto(inputs, outputs, threadContext());
+}
+
+template <typename T>
+void BasicNeuralNetwork<T>::feedForwardInto(const T* inputs, T* outputs, Workspace& context) const {
+
+    // Ensure arrays are valid 
+    if(!inputs || !outputs){
+        printf("error: please enter a valid array of inputs and outputs\n");
+        return;
+    } 
+
+    NN_PROFILE_SCOPE(PROFILE_INFERENCE, 0, 0);
+
     // convert input array to column matrix 
-    Matrix input_nodes = Matrix::fromArray(inputsArr, m_inputCount, SINGLE_COLUMN);
+    context.reserve(workspaceSize(1));
+    context.reset();
+    Matrix input_nodes = context.matrix<T>(m_inputCount, 1);
+    {
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(input_nodes));
+        input_nodes.setData(inputs);
+    }
 
-    // Input to Hidden Feed
-    // activation(weights * inputs + bias)
-    m_hidden_nodes = Matrix::product(m_weights_ih, input_nodes); // weighted sum
-    m_hidden_nodes.add(m_bias_ih);// adding bias
-    m_hidden_nodes.map(sigmoid); // applying activation function
+    Matrix nodes = context.matrix<T>(largestLayer(), 1);
+    Matrix spare = context.matrix<T>(largestLayer(), 1);
+    const Matrix& output_nodes = infer(input_nodes, nodes, spare);
 
+    // a single column is stored contiguously
+    memcpy(outputs, output_nodes.m_data, m_outputCount * sizeof(T));
 
-    // Hidden to Output Feed
-    m_output_nodes = Matrix::product(m_weights_ho, m_hidden_nodes);// weighted sum
-    m_output_nodes.add(m_bias_ho); // adding bias
-    m_output_nodes.map(sigmoid); // applying activation function
+}
 
-    // convert output into array 
-    float* output = m_output_nodes.toArray();
-    return output;
+// Feeds count samples through the network into a caller provided array
+template <typename T>
+void BasicNeuralNetwork<T>::predictBatch(const T* inputs, T* outputs, size_t count) const {
+    predictBatch(inputs, outputs, count, threadContext());
+}
+
+template <typename T>
+void BasicNeuralNetwork<T>::predictBatch(const T* inputs, T* outputs, size_t count, Workspace& context) const {
+
+    // Ensure arrays are valid 
+    if(!inputs || !outputs){
+        printf("error: please enter a valid array of inputs and outputs\n");
+        return;
+    } 
+
+    NN_PROFILE_SCOPE(PROFILE_INFERENCE, 0, 0);
+
+    // one sample per column, PREDICT_BATCH samples at a time
+    // (the context only grows when this batch is the largest so far)
+    size_t chunk = (count < PREDICT_BATCH) ? count : PREDICT_BATCH;
+    context.reserve(workspaceSize(chunk));
+
+    for(size_t first = 0; first < count; first += PREDICT_BATCH){
+        size_t batchSize = (count - first < PREDICT_BATCH) ? count - first : PREDICT_BATCH;
+
+        context.reset();
+        Matrix input_nodes = context.matrix<T>(m_inputCount, batchSize);
+        {
+            NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(input_nodes));
+            packColumns(View(inputs + first*m_inputCount, batchSize, m_inputCount), input_nodes);
+        }
+
+        Matrix nodes = context.matrix<T>(largestLayer(), batchSize);
+        Matrix spare = context.matrix<T>(largestLayer(), batchSize);
+        const Matrix& output_nodes = infer(input_nodes, nodes, spare);
+
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(output_nodes));
+        unpackColumns(output_nodes, outputs + first*m_outputCount);
+    }
+
+}
+
+// Feeds the rows of a view through the network into a caller provided array
+template <typename T>
+void BasicNeuralNetwork<T>::predictBatch(const View& inputs, T* outputs) const {
+    predictBatch(inputs, outputs, threadContext());
+}
+
+template <typename T>
+void BasicNeuralNetwork<T>::predictBatch(const View& inputs, T* outputs, Workspace& context) const {
+
+    // Ensure arrays are valid 
+    if(!inputs.m_data || !outputs || inputs.m_cols != m_inputCount){
+        printf("error: please enter a view of samples of %lu columns and a valid array of outputs\n", m_inputCount);
+        return;
+    } 
+
+    NN_PROFILE_SCOPE(PROFILE_INFERENCE, 0, 0);
+
+    // the samples are read in place, PREDICT_BATCH rows at a time
+    size_t count = inputs.m_rows;
+    size_t chunk = (count < PREDICT_BATCH) ? count : PREDICT_BATCH;
+    context.reserve(workspaceSize(chunk));
+
+    for(size_t first = 0; first < count; first += PREDICT_BATCH){
+        size_t batchSize = (count - first < PREDICT_BATCH) ? count - first : PREDICT_BATCH;
+
+        context.reset();
+        Matrix nodes = context.matrix<T>(largestLayer(), batchSize);
+        Matrix spare = context.matrix<T>(largestLayer(), batchSize);
+        const Matrix& output_nodes = infer(SampleRows<T>{inputs.rows(first, batchSize)}, nodes, spare);
+
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(output_nodes));
+        unpackColumns(output_nodes, outputs + first*m_outputCount);
+    }
+
+}
+
+// Feeds sparse samples through the network into a caller provided array
+template <typename T>
+void BasicNeuralNetwork<T>::predictBatch(const SparseMatrix& inputs, T* outputs) const {
+    predictBatch(inputs, outputs, threadContext());
+}
+
+template <typename T>
+void BasicNeuralNetwork<T>::predictBatch(const SparseMatrix& inputs, T* outputs, Workspace& context) const {
+
+    // Ensure arrays are valid 
+    if(!outputs || inputs.m_cols != m_inputCount){
+        printf("error: please enter sparse inputs of %lu columns and a valid array of outputs\n", m_inputCount);
+        return;
+    } 
+
+    NN_PROFILE_SCOPE(PROFILE_INFERENCE, 0, 0);
+
+    // the samples are read in place, PREDICT_BATCH rows at a time
+    size_t count = inputs.m_rows;
+    size_t chunk = (count < PREDICT_BATCH) ? count : PREDICT_BATCH;
+    context.reserve(workspaceSize(chunk));
+
+    for(size_t first = 0; first < count; first += PREDICT_BATCH){
+        size_t batchSize = (count - first < PREDICT_BATCH) ? count - first : PREDICT_BATCH;
+
+        context.reset();
+        Matrix nodes = context.matrix<T>(largestLayer(), batchSize);
+        Matrix spare = context.matrix<T>(largestLayer(), batchSize);
+        const Matrix& output_nodes = infer(SparseBatch<T>{&inputs, first, batchSize}, nodes, spare);
+
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(output_nodes));
+        unpackColumns(output_nodes, outputs + first*m_outputCount);
+    }
+
+}
+
+// Feeds the columns of input_nodes through the network without
+// touching the network (layers alternate between nodes and spare)
+template <typename T>
+template <typename Inputs>
+const typename BasicNeuralNetwork<T>::Matrix& BasicNeuralNetwork<T>::infer(const Inputs& input_nodes, Matrix& nodes, Matrix& spare) const {
+
+    // activation(weights * inputs + bias), layer by layer
+    const Matrix* inputs = nullptr;
+    Matrix* outputs = &nodes;
+    for(size_t l = 0; l < m_layers.size(); l++){
+        const Layer& layer = m_layers[l];
+        // weighted sum
+        if(l == 0)
+            weightedSum(layer.m_weights, input_nodes, *outputs);
+        else
+            weightedSum(layer.m_weights, *inputs, *outputs);
+        {
+            NN_PROFILE_SCOPE(PROFILE_ACTIVATION, 2 * elements(*outputs), 2 * bytes(*outputs) + bytes(layer.m_bias));
+            activate(*outputs, layer.m_bias, m_fast_activation); // adding bias, applying activation function
+        }
+        inputs = outputs;
+        outputs = (outputs == &nodes) ? &spare : &nodes;
+    }
+    return *inputs;
+
+}
+
+// Feeds the columns of input_nodes through the network
+template <typename T>
+template <typename Inputs>
+void BasicNeuralNetwork<T>::forward(const Inputs& input_nodes){
+
+    // activation(weights * inputs + bias), layer by layer
+    // (nodes are resized within the capacity reserved by reserveBatch)
+    for(size_t l = 0; l < m_layers.size(); l++){
+        Layer& layer = m_layers[l];
+        // weighted sum
+        if(l == 0)
+            weightedSum(layer.m_weights, input_nodes, layer.m_nodes);
+        else
+            weightedSum(layer.m_weights, m_layers[l-1].m_nodes, layer.m_nodes);
+        {
+            NN_PROFILE_SCOPE(PROFILE_ACTIVATION, 2 * elements(layer.m_nodes), 2 * bytes(layer.m_nodes) + bytes(layer.m_bias));
+            activate(layer.m_nodes, layer.m_bias, m_fast_activation); // adding bias, applying activation function
+        }
+    }
+
+}
+
+// Backpropagates errors from the last forward pass
+template <typename T>
+template <typename Inputs>
+void BasicNeuralNetwork<T>::backward(const Inputs& input_nodes, Matrix& errors, Scalar rate, std::vector<Layer>& targets){
+
+    size_t batchSize = errors.m_cols;
+
+    // errors of the layer before the current one
+    // (the two buffers swap roles every layer)
+    Matrix previous = m_workspace.matrix<T>(largestLayer(), batchSize);
+    Matrix* current = &errors;
+    Matrix* next = &previous;
+
+    for(size_t l = m_layers.size(); l-- > 0; ){
+        Layer& layer = m_layers[l];
+
+        // Calculate errors of the layer before (before its weights change)
+        // weights^T * errors (read in place, no transposed copy)
+        if(l > 0){
+            NN_PROFILE_SCOPE(PROFILE_BACKPROP_ERRORS, productFlops(layer.m_weights, *current), productBytes(layer.m_weights, *current));
+            Matrix::productTNInto(layer.m_weights, *current, *next);
+        }
+
+        // Calculate gradients
+        // (gradients overwrite the errors, which are no longer needed)
+        Matrix& gradients = *current;
+        {
+            NN_PROFILE_SCOPE(PROFILE_GRADIENTS, 3 * elements(gradients), 3 * bytes(gradients));
+            gradients = *current * map(layer.m_nodes, dsigmoid<Scalar>);
+        }
+
+        // Change weights
+        if(l == 0)
+            updateLayer(rate, gradients, input_nodes, targets[l].m_weights, targets[l].m_bias);
+        else
+            updateLayer(rate, gradients, m_layers[l-1].m_nodes, targets[l].m_weights, targets[l].m_bias);
+
+        Matrix* swap = current;
+        current = next;
+        next = swap;
+    }
 
 }
 
@@ -98,44 +718,430 @@ float* NeuralNetwork::feedForward(float* inputsArr){
 // feeds forward a given input
 // changes weights if output doesnt match given expected answer 
 // uses stochastic gradient descent - alters weights after each feed forward
-void NeuralNetwork::train(float* inputs_arr, float* answers_arr){
+template <typename T>
+void BasicNeuralNetwork<T>::train(const T* inputs_arr, const T* answers_arr){
+
+    // Ensure inputs are valid 
+    if(!inputs_arr || !answers_arr){
+        printf("error: please enter a valid array of inputs and answers\n");
+        return;
+    } 
+
+    if(m_optimizer){
+        m_optimizer->trainBatch(inputs_arr, answers_arr, 1);
+        return;
+    }
+
+    NN_PROFILE_SCOPE(PROFILE_TRAIN, 0, 0);
+
+    // every temporary of this step lives in the workspace
+    m_workspace.reset();
 
     // Convert params to matrices 
-    Matrix inputs = Matrix::fromArray(inputs_arr, m_inputCount, SINGLE_COLUMN);
-    Matrix outputs = Matrix::fromArray(feedForward(inputs_arr), m_outputCount, SINGLE_COLUMN);
-    Matrix answers = Matrix::fromArray(answers_arr, m_outputCount, SINGLE_COLUMN);
+    Matrix inputs = m_workspace.matrix<T>(m_inputCount, 1);
+    {
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(inputs));
+        inputs.setData(inputs_arr);
+    }
+
+    // Feed forward
+    // (fills the nodes of every layer)
+    forward(inputs);
 
     // calculate error <output>
     // error = answer - output
-    Matrix output_errors = Matrix::subtract(answers, outputs);
+    Matrix output_errors = m_workspace.matrix<T>(largestLayer(), 1);
+    output_errors.resize(m_outputCount, 1);
+    {
+        NN_PROFILE_SCOPE(PROFILE_OUTPUT_ERROR, elements(output_errors), 3 * bytes(output_errors));
+        output_errors.setData(answers_arr);
+        output_errors.subtract(m_layers.back().m_nodes);
+    }
+
+    backward(inputs, output_errors, m_learning_rate, m_layers);
+
+}
+
+//========================================================================
+
+// MINI-BATCH TRAINING
+// trains on batchSize samples at once and applies one update
+// with the gradients averaged over the batch
+template <typename T>
+void BasicNeuralNetwork<T>::trainBatch(const T* inputs, const T* answers, size_t batchSize){
+
+    // Ensure inputs are valid 
+    if(!inputs || !answers || batchSize == 0){
+        printf("error: please enter a valid batch of inputs and answers\n");
+        return;
+    } 
+
+    if(m_optimizer){
+        m_optimizer->trainBatch(inputs, answers, batchSize);
+        return;
+    }
+
+    // gradients are averaged over the batch
+    step(inputs, answers, batchSize, m_learning_rate / batchSize, m_layers);
+
+}
+
+// Trains on the samples in the rows of a view
+template <typename T>
+void BasicNeuralNetwork<T>::trainBatch(const View& inputs, const View& answers){
+
+    // Ensure inputs are valid 
+    if(!inputs.m_data || !answers.m_data || inputs.m_rows == 0 || inputs.m_rows != answers.m_rows
+        || inputs.m_cols != m_inputCount || answers.m_cols != m_outputCount){
+        printf("error: please enter views of the same samples with %lu inputs and %lu answers\n", m_inputCount, m_outputCount);
+        return;
+    } 
+
+    if(m_optimizer){
+        m_optimizer->trainBatch(inputs, answers);
+        return;
+    }
+
+    // gradients are averaged over the batch
+    step(inputs, answers, m_learning_rate / inputs.m_rows, m_layers);
+
+}
+
+// Trains on a batch of sparse samples (every row of inputs)
+template <typename T>
+void BasicNeuralNetwork<T>::trainBatch(const SparseMatrix& inputs, const T* answers){
+
+    // Ensure inputs are valid 
+    if(!answers || inputs.m_rows == 0 || inputs.m_cols != m_inputCount){
+        printf("error: please enter a batch of sparse inputs of %lu columns and valid answers\n", m_inputCount);
+        return;
+    } 
+
+    if(m_optimizer){
+        m_optimizer->trainBatch(inputs, answers);
+        return;
+    }
+
+    // gradients are averaged over the batch
+    step(inputs, answers, m_learning_rate / inputs.m_rows, m_layers);
+
+}
+
+// GRADIENTS
+// adds rate * gradients of a batch into gradients without training
+template <typename T>
+void BasicNeuralNetwork<T>::accumulateGradients(const T* inputs, const T* answers, size_t batchSize, Scalar rate, std::vector<Layer>& gradients){
+
+    // Ensure inputs are valid 
+    if(!inputs || !answers || batchSize == 0){
+        printf("error: please enter a valid batch of inputs and answers\n");
+        return;
+    } 
+    if(gradients.size() != m_layers.size()){
+        printf("error: gradients must have one entry per layer\n");
+        return;
+    }
+
+    step(inputs, answers, batchSize, rate, gradients);
+
+}
+
+template <typename T>
+void BasicNeuralNetwork<T>::accumulateGradients(const View& inputs, const View& answers, Scalar rate, std::vector<Layer>& gradients){
+
+    // Ensure inputs are valid 
+    if(!inputs.m_data || !answers.m_data || inputs.m_rows == 0 || inputs.m_rows != answers.m_rows
+        || inputs.m_cols != m_inputCount || answers.m_cols != m_outputCount){
+        printf("error: please enter views of the same samples with %lu inputs and %lu answers\n", m_inputCount, m_outputCount);
+        return;
+    } 
+    if(gradients.size() != m_layers.size()){
+        printf("error: gradients must have one entry per layer\n");
+        return;
+    }
+
+    step(inputs, answers, rate, gradients);
+
+}
+
+template <typename T>
+void BasicNeuralNetwork<T>::accumulateGradients(const SparseMatrix& inputs, const T* answers, Scalar rate, std::vector<Layer>& gradients){
+
+    // Ensure inputs are valid 
+    if(!answers || inputs.m_rows == 0 || inputs.m_cols != m_inputCount){
+        printf("error: please enter a batch of sparse inputs of %lu columns and valid answers\n", m_inputCount);
+        return;
+    } 
+    if(gradients.size() != m_layers.size()){
+        printf("error: gradients must have one entry per layer\n");
+        return;
+    }
+
+    step(inputs, answers, rate, gradients);
+
+}
 
-    // Calculate Hidden Errors (hidden -> output)
-    Matrix weights_ho_t = Matrix::transpose(m_weights_ho);
-    Matrix hidden_errors = Matrix::product(weights_ho_t, output_errors);
+// Runs a batch forward and backward into targets
+template <typename T>
+void BasicNeuralNetwork<T>::step(const T* inputs, const T* answers, size_t batchSize, Scalar rate, std::vector<Layer>& targets){
 
-    // Calculate Change in Weights hidden -> output
-    Matrix hidden_gradients = Matrix::multiply(output_errors, Matrix::map(outputs, dsigmoid));
-    Matrix hidden_nodes_t = Matrix::transpose(m_hidden_nodes);
-    Matrix delta_weights_ho = Matrix::product(hidden_gradients, hidden_nodes_t);
-    delta_weights_ho.multiply(m_learning_rate);
-    Matrix delta_bias_ho = Matrix::multiply(hidden_gradients, m_learning_rate);
+    NN_PROFILE_SCOPE(PROFILE_TRAIN, 0, 0);
 
-    // Change weights
-    m_weights_ho.add(delta_weights_ho);
-    m_bias_ho.add(delta_bias_ho);
+    // every temporary of this step lives in the workspace
+    // (node values and scratch only grow when this batch is the largest so far)
+    reserveBatch(batchSize);
+    m_workspace.reserve(workspaceSize(batchSize));
+    m_workspace.reset();
 
-    // Calculate Change in Weights input -> hidden
-    Matrix input_gradients = Matrix::multiply(hidden_errors, Matrix::map(m_hidden_nodes, dsigmoid));
-    Matrix input_nodes_t = Matrix::transpose(inputs);
-    Matrix delta_weights_ih = Matrix::product(input_gradients, input_nodes_t);
-    delta_weights_ih.multiply(m_learning_rate);
-    Matrix delta_bias_ih = Matrix::multiply(input_gradients, m_learning_rate);
+    // Pack the batch into a matrix, one sample per column
+    // inputCount x batchSize
+    Matrix input_nodes = m_workspace.matrix<T>(m_inputCount, batchSize);
+    {
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(input_nodes));
+        packColumns(View(inputs, batchSize, m_inputCount), input_nodes);
+    }
 
-    // Change weights
-    m_weights_ih.add(delta_weights_ih);
-    m_bias_ih.add(delta_bias_ih);
+    descend(input_nodes, View(answers, batchSize, m_outputCount), rate, targets);
 
 }
-    
+
+// Runs the samples in the rows of a view forward and backward into targets
+template <typename T>
+void BasicNeuralNetwork<T>::step(const View& inputs, const View& answers, Scalar rate, std::vector<Layer>& targets){
+
+    NN_PROFILE_SCOPE(PROFILE_TRAIN, 0, 0);
+
+    size_t batchSize = inputs.m_rows;
+    reserveBatch(batchSize);
+    m_workspace.reserve(workspaceSize(batchSize));
+    m_workspace.reset();
+
+    // the samples are read in place (no packing)
+    descend(SampleRows<T>{inputs}, answers, rate, targets);
+
+}
+
+// Runs a batch of sparse samples forward and backward into targets
+template <typename T>
+void BasicNeuralNetwork<T>::step(const SparseMatrix& inputs, const T* answers, Scalar rate, std::vector<Layer>& targets){
+
+    NN_PROFILE_SCOPE(PROFILE_TRAIN, 0, 0);
+
+    size_t batchSize = inputs.m_rows;
+    reserveBatch(batchSize);
+    m_workspace.reserve(workspaceSize(batchSize));
+    m_workspace.reset();
+
+    // the samples are read in place (no packing)
+    descend(SparseBatch<T>{&inputs, 0, batchSize}, View(answers, batchSize, m_outputCount), rate, targets);
+
+}
+
+// Packs the answers and runs the batch forward and backward
+template <typename T>
+template <typename Inputs>
+void BasicNeuralNetwork<T>::descend(const Inputs& input_nodes, const View& answers, Scalar rate, std::vector<Layer>& targets){
+
+    size_t batchSize = answers.m_rows;
+
+    // outputCount x batchSize (with room for the errors of any layer)
+    Matrix output_errors = m_workspace.matrix<T>(largestLayer(), batchSize);
+    output_errors.resize(m_outputCount, batchSize);
+    {
+        NN_PROFILE_SCOPE(PROFILE_PACK, 0, 2 * bytes(output_errors));
+        packColumns(answers, output_errors);
+    }
+
+    // Feed forward
+    // (fills the nodes of every layer, one column per sample)
+    forward(input_nodes);
+
+    // calculate error <output>
+    // error = answer - output
+    {
+        NN_PROFILE_SCOPE(PROFILE_OUTPUT_ERROR, elements(output_errors), 3 * bytes(output_errors));
+        output_errors.subtract(m_layers.back().m_nodes);
+    }
+
+    backward(input_nodes, output_errors, rate, targets);
+
+}
+
+//========================================================================
+// SAVING AND LOADING
+
+// Element type of a network in model files
+template <typename T> static uint32_t modelDtype();
+template <> uint32_t modelDtype<float>() { return MODEL_FLOAT32; }
+template <> uint32_t modelDtype<double>() { return MODEL_FLOAT64; }
+
+// Returns the offset of the parameters in a file of layerCount layers
+static size_t modelDataOffset(size_t layerCount){
+    size_t size = sizeof(ModelHeader) + layerCount * sizeof(uint64_t);
+    return (size + WORKSPACE_ALIGNMENT - 1) / WORKSPACE_ALIGNMENT * WORKSPACE_ALIGNMENT;
+}
+
+// Writes the network to a model file
+template <typename T>
+bool BasicNeuralNetwork<T>::save(const char* path) const {
+
+    // Ensure path is valid 
+    if(!path){
+        printf("error: please enter a valid path\n");
+        return false;
+    } 
+
+    // the parameters as they are laid out in the file
+    // (copied layer by layer so padding is zeroed, whoever owns them)
+    Workspace data (Workspace::footprint (parameterSize(), sizeof(T)));
+    memset(data.m_data, 0, data.m_capacity * sizeof(float));
+    std::vector<Layer> layers;
+    bindLayers((T*) data.m_data, layers);
+    for(size_t l = 0; l < m_layers.size(); l++){
+        layers[l].m_weights = m_layers[l].m_weights;
+        layers[l].m_bias = m_layers[l].m_bias;
+    }
+    size_t dataSize = parameterSize() * sizeof(T);
+
+    // header, layer sizes, then zero padding up to the parameters
+    size_t dataOffset = modelDataOffset(m_layerSizes.size());
+    std::vector<unsigned char> head (dataOffset, 0);
+    ModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, MODEL_MAGIC, sizeof(header.m_magic));
+    header.m_version = MODEL_VERSION;
+    header.m_dtype = modelDtype<T>();
+    header.m_alignment = WORKSPACE_ALIGNMENT;
+    header.m_flags = m_fast_activation ? MODEL_FAST_ACTIVATION : 0;
+    header.m_layerCount = m_layerSizes.size();
+    header.m_dataOffset = dataOffset;
+    header.m_dataSize = dataSize;
+    header.m_checksum = modelChecksum(data.m_data, dataSize);
+    header.m_learningRate = m_learning_rate;
+    memcpy(head.data(), &header, sizeof(header));
+    for(size_t i = 0; i < m_layerSizes.size(); i++){
+        uint64_t size = m_layerSizes[i];
+        memcpy(head.data() + sizeof(header) + i * sizeof(size), &size, sizeof(size));
+    }
+
+    FILE* file = fopen(path, "wb");
+    if(!file){
+        printf("error: could not open %s for writing\n", path);
+        return false;
+    }
+    bool written = fwrite(head.data(), 1, dataOffset, file) == dataOffset
+                && fwrite(data.m_data, 1, dataSize, file) == dataSize;
+    written = (fclose(file) == 0) && written;
+    if(!written){
+        printf("error: could not write %s\n", path);
+    }
+    return written;
+
+}
+
+// Loads a network from a model file into its own memory
+template <typename T>
+BasicNeuralNetwork<T>* BasicNeuralNetwork<T>::load(const char* path){
+
+    // map it, then copy out of the mapping
+    BasicNeuralNetwork* mapped = loadMapped(path, true);
+    if(!mapped){
+        return nullptr;
+    }
+    BasicNeuralNetwork* network = new BasicNeuralNetwork (*mapped);
+    delete mapped;
+    return network;
+
+}
+
+// Loads a network that points straight into the mapped file
+template <typename T>
+BasicNeuralNetwork<T>* BasicNeuralNetwork<T>::loadMapped(const char* path, bool verify){
+
+    // Ensure path is valid 
+    if(!path){
+        printf("error: please enter a valid path\n");
+        return nullptr;
+    } 
+
+    MappedFile file;
+    if(!file.open(path)){
+        return nullptr;
+    }
+
+    // Ensure the header describes this kind of network
+    ModelHeader header;
+    if(file.m_size < sizeof(header)){
+        printf("error: %s is too small to be a model\n", path);
+        return nullptr;
+    }
+    memcpy(&header, file.m_data, sizeof(header));
+    if(memcmp(header.m_magic, MODEL_MAGIC, sizeof(header.m_magic)) != 0){
+        printf("error: %s is not a model file\n", path);
+        return nullptr;
+    }
+    if(header.m_version != MODEL_VERSION){
+        printf("error: %s is a version %u model, expected version %u\n", path, header.m_version, MODEL_VERSION);
+        return nullptr;
+    }
+    if(header.m_dtype != modelDtype<T>()){
+        printf("error: %s holds a different element type than this network\n", path);
+        return nullptr;
+    }
+    if(header.m_alignment != WORKSPACE_ALIGNMENT){
+        printf("error: %s is aligned to %u bytes, expected %lu\n", path, header.m_alignment, WORKSPACE_ALIGNMENT);
+        return nullptr;
+    }
+    // (the layer count is bounded by the file before the offset is computed)
+    if(header.m_layerCount < 2 || header.m_layerCount > (file.m_size - sizeof(header)) / sizeof(uint64_t)
+       || header.m_dataOffset != modelDataOffset(header.m_layerCount)
+       || header.m_dataOffset > file.m_size || header.m_dataSize > file.m_size - header.m_dataOffset){
+        printf("error: %s is truncated or corrupt\n", path);
+        return nullptr;
+    }
+
+    std::vector<size_t> layerSizes (header.m_layerCount);
+    for(size_t i = 0; i < layerSizes.size(); i++){
+        uint64_t size;
+        memcpy(&size, file.m_data + sizeof(header) + i * sizeof(size), sizeof(size));
+        layerSizes[i] = size;
+        if(size == 0){
+            printf("error: %s has an empty layer\n", path);
+            return nullptr;
+        }
+    }
+
+    // the parameters the layers need must be the ones in the file before
+    // anything is sized for them (so the file bounds every allocation)
+    size_t parameterCount;
+    if(!parameterSizeFor(layerSizes, parameterCount)
+       || header.m_dataSize % sizeof(T) != 0 || header.m_dataSize / sizeof(T) != parameterCount){
+        printf("error: %s has the wrong amount of parameters for its layers\n", path);
+        return nullptr;
+    }
+
+    BasicNeuralNetwork* network = new BasicNeuralNetwork ();
+    network->setLayerSizes(layerSizes);
+
+    T* data = (T*) (file.m_data + header.m_dataOffset);
+    if(verify && modelChecksum(data, header.m_dataSize) != header.m_checksum){
+        printf("error: %s failed its checksum\n", path);
+        delete network;
+        return nullptr;
+    }
+
+    // the layers point straight into the mapped pages
+    network->bindLayers(data, network->m_layers);
+    network->m_mapping = std::move(file);
+    network->m_learning_rate = header.m_learningRate;
+    network->m_fast_activation = (header.m_flags & MODEL_FAST_ACTIVATION) != 0;
+    return network;
+
+}
+
+//========================================================================
+// Element types the network is built for
+template class BasicNeuralNetwork<float>;
+template class BasicNeuralNetwork<double>;
 
 //========================================================================
@@ -8,54 +8,278 @@
 
 //========================================================================
 
+#include <vector>
 #include "matrix.hpp"
+#include "modelfile.hpp"
+#include "sparse.hpp"
+#include "workspace.hpp"
 
 //========================================================================
 
+template <typename T> class BasicOptimizer;
 
-class NeuralNetwork
+// Neural network with elements of type T (float or double)
+// - NeuralNetwork is the float instantiation
+// - double is meant for validating gradients
+// Fully connected layers with sigmoid activations, any depth.
+template <typename T>
+class BasicNeuralNetwork
 {
 
 public:
+    typedef BasicMatrix<T> Matrix;
+    typedef typename Matrix::Scalar Scalar;
+    typedef typename Matrix::View View;
+    typedef BasicSparseMatrix<T> SparseMatrix;
+
+    // One fully connected layer (the nodes it computes and what feeds them)
+    // every matrix is a view, weights and biases into m_parameters and
+    // nodes into m_activations
+    struct Layer
+    {
+        // nodes x nodes of the previous layer
+        Matrix m_weights;
+        // nodes x 1
+        Matrix m_bias;
+        // nodes x batch
+        // node values of the last train call
+        Matrix m_nodes;
+    };
+
+    // number of nodes in each layer, inputs first and outputs last
+    std::vector<size_t> m_layerSizes;
     size_t m_inputCount; 
-    size_t m_hiddenCount; 
     size_t m_outputCount;
 
-    // hiddenCount x inputCount
-    Matrix m_weights_ih;
-    // outputCount x hiddenCount 
-    Matrix m_weights_ho;
-    // bias
-    // one bias for each layer
-    // connected to each of the next layer
-    // hiddenCount x 1 
-    Matrix m_bias_ih;
-    // outputCount x 1
-    Matrix m_bias_ho;
+    // one entry per layer after the inputs (the last is the output layer)
+    std::vector<Layer> m_layers;
+
+    // every weight and bias in one allocation
+    // laid out layer by layer (weights then bias) in the order a forward
+    // pass reads them, each matrix (and each row of weights) starting on
+    // a cache line
+    // (empty when the parameters are shared or mapped from a file)
+    Workspace m_parameters;
+
+    // the model file the parameters point into (see loadMapped)
+    MappedFile m_mapping;
+
+    // the node values of every layer in one allocation
+    // sized for the largest batch seen so far
+    Workspace m_activations;
+    size_t m_batchCapacity;
+
+    // scratch memory for the temporaries of one train step
+    // sized once in the ctor and reset at the start of every step
+    Workspace m_workspace;
 
-    // previous node values 
-    Matrix m_hidden_nodes; 
-    Matrix m_output_nodes; 
+    Scalar m_learning_rate = 0.1;
 
-    float  m_learning_rate = 0.1;
+    // when set, train and trainBatch hand the gradients to it instead of
+    // doing a plain SGD step with m_learning_rate (see optimizer.hpp)
+    // not owned, and not carried over by copies
+    BasicOptimizer<T>* m_optimizer = nullptr;
+
+    // use the faster sigmoid approximation (max abs error 1.9e-4
+    // instead of 8.9e-8, see SimdKernels::sigmoidFast)
+    bool   m_fast_activation = false;
 
     // Constructs the neural network
+    // params - number of nodes per layer: input, hidden..., output
+    // (at least an input and an output layer)
+    explicit BasicNeuralNetwork (const std::vector<size_t>& layerSizes);
+
+    // Constructs a network with a single hidden layer
     // params - input, hidden, output
-    NeuralNetwork (size_t inputCount, size_t hiddenCount, size_t outputCount);
+    BasicNeuralNetwork (size_t inputCount, size_t hiddenCount, size_t outputCount);
+
+    // Copies are deep (layers are rebound to the copy's own memory)
+    BasicNeuralNetwork (const BasicNeuralNetwork& other);
+    BasicNeuralNetwork& operator= (const BasicNeuralNetwork& other);
+
+    // PARAMETERS
+
+    // Returns the size (in elements of T, padding included) of a block
+    // holding every weight and bias
+    size_t parameterSize() const;
+
+    // Points the weights and biases of layers into block (parameterSize()
+    // elements, starting on a cache line) laid out like m_parameters,
+    // one entry per layer
+    // (node matrices are left alone)
+    void bindLayers(T* block, std::vector<Layer>& layers) const;
+
+    // Uses other's weights and biases instead of this network's own
+    // (releasing them), so training either network changes both
+    // other must have the same layer sizes and outlive this network
+    void shareParameters(const BasicNeuralNetwork& other);
+
+    // INFERENCE
+    // The inference methods are const: they only read the weights and keep
+    // their node values in a context, so any number of threads can run
+    // them on one shared network (as long as nobody trains it meanwhile).
+    // A context is any Workspace, one per thread (or per call). Without
+    // one, the calling thread's own context is used.
 
     // Feed Forward Algorithm
     // Feeds input through neural network to arive at an output
     // param inputs - must be an array of desired inputs. (must be size of inputCount)
-    float* feedForward(float* inputsArr);
+    // Note: the returned array is malloc'd and must be freed by the caller
+    T* feedForward(const T* inputsArr) const;
+
+    // Same as feedForward but writes the outputCount outputs into outputs
+    // Note: does not allocate once the context has been used with this network
+    void feedForwardInto(const T* inputs, T* outputs) const;
+    void feedForwardInto(const T* inputs, T* outputs, Workspace& context) const;
+
+    // Feeds count samples through the network at once
+    // param inputs - count samples of inputCount values, one after another
+    // param outputs - receives count samples of outputCount values
+    // samples run as matrix-matrix products, up to 64 at a time
+    // Note: only allocates the first time a context sees a batch of a new
+    // largest size (capped at 64), also when its products are split
+    // across the thread pool (see gemm.hpp)
+    void predictBatch(const T* inputs, T* outputs, size_t count) const;
+    void predictBatch(const T* inputs, T* outputs, size_t count, Workspace& context) const;
+
+    // Same as predictBatch for the samples in the rows of a view (e.g. a
+    // slice of a dataset, see MatrixView), read in place without packing
+    void predictBatch(const View& inputs, T* outputs) const;
+    void predictBatch(const View& inputs, T* outputs, Workspace& context) const;
+
+    // Same as predictBatch for sparse samples, one per row of inputs
+    // (inputCount columns), the first layer costs its nodes times the
+    // nonzeros of a sample instead of times inputCount
+    void predictBatch(const SparseMatrix& inputs, T* outputs) const;
+    void predictBatch(const SparseMatrix& inputs, T* outputs, Workspace& context) const;
 
     // TRAINING NEURAL NETWORK
     // feeds forward a given input
     // changes weights if output doesnt match given expected answer 
     // uses stochastic gradient descent - alters weights after each feed forward
-    void train(float* inputs_arr, float* answers_arr);
+    // Note: does not allocate once the network is constructed
+    void train(const T* inputs_arr, const T* answers_arr);
+
+    // MINI-BATCH TRAINING
+    // trains on batchSize samples at once and applies one update
+    // with the gradients averaged over the batch
+    // param inputs - batchSize samples of inputCount values, one after another
+    // param answers - batchSize samples of outputCount values, one after another
+    // the batch runs through the network as matrix-matrix products
+    // Note: only allocates when a batch is larger than any seen before,
+    // also when its products are split across the thread pool
+    void trainBatch(const T* inputs, const T* answers, size_t batchSize);
+
+    // Same as trainBatch for the samples in the rows of views (the batch
+    // is every row), inputs are read in place without packing
+    // param inputs - batchSize x inputCount
+    // param answers - batchSize x outputCount
+    void trainBatch(const View& inputs, const View& answers);
+
+    // Same as trainBatch for sparse samples, one per row of inputs
+    // (the batch is every row), only the first layer weights of the
+    // columns where a sample is nonzero are read and changed
+    void trainBatch(const SparseMatrix& inputs, const T* answers);
+
+    // SAVING AND LOADING
+    // see modelfile.hpp for the format
+
+    // Writes the network to a model file
+    // returns false (and prints why) if it could not
+    bool save(const char* path) const;
+
+    // Loads a network from a model file into its own memory
+    // (the checksum is always verified)
+    // returns nullptr (and prints why) if the file is not a valid model
+    // of this element type
+    // Note: the returned network is new'd and must be deleted by the caller
+    static BasicNeuralNetwork* load(const char* path);
+
+    // Loads a network whose weights and biases point straight into the
+    // mapped file, without copying (copy-on-write: training it changes
+    // only this process's pages)
+    // only the header is read up front, the weights are paged in as
+    // they are first used, so loading does not depend on the model size
+    // verify - also check the checksum (reads every page)
+    // Note: the returned network is new'd and must be deleted by the caller
+    static BasicNeuralNetwork* loadMapped(const char* path, bool verify = false);
+
+    // GRADIENTS
+    // same as trainBatch but leaves the weights alone and instead adds
+    // rate * gradients (summed over the batch) into gradients, a set of
+    // layers bound with bindLayers
+    // rate is not divided by the batch size
+    void accumulateGradients(const T* inputs, const T* answers, size_t batchSize, Scalar rate, std::vector<Layer>& gradients);
+    void accumulateGradients(const View& inputs, const View& answers, Scalar rate, std::vector<Layer>& gradients);
+    void accumulateGradients(const SparseMatrix& inputs, const T* answers, Scalar rate, std::vector<Layer>& gradients);
+
+private:
+
+    // Constructs an empty network (see setLayerSizes)
+    BasicNeuralNetwork();
+
+    // Sets the layer sizes and sizes the node values and scratch
+    // (parameters are left to the caller)
+    void setLayerSizes(const std::vector<size_t>& layerSizes);
+
+    // Computes the size (in elements of T) of a parameter block for
+    // layerSizes (see parameterSize) into size
+    // returns false if it does not fit in a size_t
+    static bool parameterSizeFor(const std::vector<size_t>& layerSizes, size_t& size);
+
+    // Returns the workspace size (in floats) needed for a batch
+    size_t workspaceSize(size_t batchSize) const;
+
+    // Returns the number of nodes in the largest layer after the inputs
+    size_t largestLayer() const;
+
+    // Points every layer's weights and biases into m_parameters
+    void bindParameters();
+
+    // Runs a batch forward and backward, adding rate * gradients into
+    // targets (m_layers to train, a gradient set to accumulate)
+    void step(const T* inputs, const T* answers, size_t batchSize, Scalar rate, std::vector<Layer>& targets);
+    void step(const View& inputs, const View& answers, Scalar rate, std::vector<Layer>& targets);
+    void step(const SparseMatrix& inputs, const T* answers, Scalar rate, std::vector<Layer>& targets);
+
+    // The part of a step after the inputs are ready: packs the answers
+    // (batchSize x outputCount), then runs forward and backward
+    template <typename Inputs>
+    void descend(const Inputs& input_nodes, const View& answers, Scalar rate, std::vector<Layer>& targets);
+
+    // Makes room for batchSize columns of node values in every layer
+    // (m_activations is only reallocated when it grows)
+    void reserveBatch(size_t batchSize);
+
+    // The methods below take their inputs as a Matrix (one sample per
+    // column), as the rows of a view or as a batch of rows of a
+    // SparseMatrix (see neuralnet.cpp)
+
+    // Feeds the columns of input_nodes through the network
+    // leaving each layer's node values in its m_nodes
+    template <typename Inputs>
+    void forward(const Inputs& input_nodes);
+
+    // Feeds the columns of input_nodes through the network without
+    // changing it, layers alternate between the nodes and spare buffers
+    // (each with room for the largest layer)
+    // returns whichever of the two holds the outputs
+    template <typename Inputs>
+    const Matrix& infer(const Inputs& input_nodes, Matrix& nodes, Matrix& spare) const;
+
+    // Backpropagates errors (answers - outputs) from the last forward
+    // pass and adds rate * gradients to the weights and biases of targets
+    // (m_layers itself to train)
+    // errors must be a workspace matrix with room for the largest layer
+    template <typename Inputs>
+    void backward(const Inputs& input_nodes, Matrix& errors, Scalar rate, std::vector<Layer>& targets);
     
 };
 
+// Element types (defined in neuralnet.cpp)
+typedef BasicNeuralNetwork<float> NeuralNetwork;
+typedef BasicNeuralNetwork<double> NeuralNetworkDouble;
+
 //========================================================================
 
 #endif 
\ No newline at end of file
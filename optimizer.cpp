@@ -0,0 +1,362 @@
+// Optimizers
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "optimizer.hpp"
+#include "profile.hpp"
+#include "simd.hpp"
+
+//========================================================================
+
+const char* optimizerName (OptimizerKind kind)
+{
+    switch (kind) {
+        case OPTIMIZER_MOMENTUM: return "momentum";
+        case OPTIMIZER_RMSPROP:  return "rmsprop";
+        case OPTIMIZER_ADAM:     return "adam";
+        default:                 return "sgd";
+    }
+}
+
+//========================================================================
+// FUSED UPDATE KERNELS
+// one pass over the parameters, each element's parameter, state and
+// direction are loaded and stored once
+// V is the element type itself (scalar) or a GCC vector of E
+
+typedef float v4f  __attribute__ ((vector_size (16)));
+typedef float v8f  __attribute__ ((vector_size (32)));
+typedef float v16f __attribute__ ((vector_size (64)));
+
+// square root of every lane, in place
+// (the vector versions inline into the kernel of their instruction set)
+static inline void sqrtLanes (float& x) { x = __builtin_sqrtf (x); }
+static inline void sqrtLanes (double& x) { x = __builtin_sqrt (x); }
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__ ((target ("sse2")))
+static inline void sqrtLanes (v4f& x) { x = (v4f) _mm_sqrt_ps ((__m128) x); }
+__attribute__ ((target ("avx")))
+static inline void sqrtLanes (v8f& x) { x = (v8f) _mm256_sqrt_ps ((__m256) x); }
+__attribute__ ((target ("avx512f")))
+static inline void sqrtLanes (v16f& x) { x = (v16f) _mm512_sqrt_ps ((__m512) x); }
+#endif
+
+// v = beta * v + d, p += rate * v
+template <typename V, typename E>
+static inline __attribute__ ((always_inline))
+void momentumLoop (E* p, E* v, const E* d, E rate, E beta, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(E);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V vp, vv, vd;
+        memcpy (&vp, p + i, sizeof(V));
+        memcpy (&vv, v + i, sizeof(V));
+        memcpy (&vd, d + i, sizeof(V));
+        vv = vv * beta + vd;
+        vp += vv * rate;
+        memcpy (v + i, &vv, sizeof(V));
+        memcpy (p + i, &vp, sizeof(V));
+    }
+    for (; i < n; i++) {
+        v[i] = v[i] * beta + d[i];
+        p[i] += v[i] * rate;
+    }
+}
+
+// s = beta * s + (1 - beta) * d^2, p += rate * d / (sqrt(s) + epsilon)
+template <typename V, typename E>
+static inline __attribute__ ((always_inline))
+void rmspropLoop (E* p, E* s, const E* d, E rate, E beta, E epsilon, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(E);
+    const E keep = 1 - beta;
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V vp, vs, vd;
+        memcpy (&vp, p + i, sizeof(V));
+        memcpy (&vs, s + i, sizeof(V));
+        memcpy (&vd, d + i, sizeof(V));
+        vs = vs * beta + vd * vd * keep;
+        V root = vs;
+        sqrtLanes (root);
+        vp += vd * rate / (root + epsilon);
+        memcpy (s + i, &vs, sizeof(V));
+        memcpy (p + i, &vp, sizeof(V));
+    }
+    for (; i < n; i++) {
+        s[i] = s[i] * beta + d[i] * d[i] * keep;
+        E root = s[i];
+        sqrtLanes (root);
+        p[i] += d[i] * rate / (root + epsilon);
+    }
+}
+
+// m = beta1 * m + (1 - beta1) * d, v = beta2 * v + (1 - beta2) * d^2,
+// p += step * m / (sqrt(v) + epsilon)
+// (step and epsilon already carry the bias correction)
+template <typename V, typename E>
+static inline __attribute__ ((always_inline))
+void adamLoop (E* p, E* m, E* v, const E* d, E step, E beta1, E beta2, E epsilon, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(E);
+    const E keep1 = 1 - beta1;
+    const E keep2 = 1 - beta2;
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V vp, vm, vv, vd;
+        memcpy (&vp, p + i, sizeof(V));
+        memcpy (&vm, m + i, sizeof(V));
+        memcpy (&vv, v + i, sizeof(V));
+        memcpy (&vd, d + i, sizeof(V));
+        vm = vm * beta1 + vd * keep1;
+        vv = vv * beta2 + vd * vd * keep2;
+        V root = vv;
+        sqrtLanes (root);
+        vp += vm * step / (root + epsilon);
+        memcpy (m + i, &vm, sizeof(V));
+        memcpy (v + i, &vv, sizeof(V));
+        memcpy (p + i, &vp, sizeof(V));
+    }
+    for (; i < n; i++) {
+        m[i] = m[i] * beta1 + d[i] * keep1;
+        v[i] = v[i] * beta2 + d[i] * d[i] * keep2;
+        E root = v[i];
+        sqrtLanes (root);
+        p[i] += m[i] * step / (root + epsilon);
+    }
+}
+
+//========================================================================
+
+// Table of fused float updates for one instruction set
+struct OptimizerKernels
+{
+    void (*momentum) (float* p, float* v, const float* d, float rate, float beta, size_t n);
+    void (*rmsprop)  (float* p, float* s, const float* d, float rate, float beta, float epsilon, size_t n);
+    void (*adam)     (float* p, float* m, float* v, const float* d, float step,
+                      float beta1, float beta2, float epsilon, size_t n);
+};
+
+#define OPTIMIZER_KERNEL_SET(NAME, TARGET, V)                                                      \
+    TARGET static void momentum##NAME (float* p, float* v, const float* d, float rate,             \
+                                       float beta, size_t n)                                       \
+        { momentumLoop<V, float> (p, v, d, rate, beta, n); }                                       \
+    TARGET static void rmsprop##NAME (float* p, float* s, const float* d, float rate,              \
+                                      float beta, float epsilon, size_t n)                         \
+        { rmspropLoop<V, float> (p, s, d, rate, beta, epsilon, n); }                               \
+    TARGET static void adam##NAME (float* p, float* m, float* v, const float* d, float step,       \
+                                   float beta1, float beta2, float epsilon, size_t n)              \
+        { adamLoop<V, float> (p, m, v, d, step, beta1, beta2, epsilon, n); }                       \
+    static const OptimizerKernels s_optimizerKernels##NAME = {                                     \
+        momentum##NAME, rmsprop##NAME, adam##NAME                                                  \
+    };
+
+OPTIMIZER_KERNEL_SET (Scalar, , float)
+
+#if defined(__x86_64__) || defined(__i386__)
+OPTIMIZER_KERNEL_SET (Sse2,   __attribute__ ((target ("sse2"))),    v4f)
+OPTIMIZER_KERNEL_SET (Avx2,   __attribute__ ((target ("avx2"))),    v8f)
+OPTIMIZER_KERNEL_SET (Avx512, __attribute__ ((target ("avx512f"))), v16f)
+#endif
+
+// Returns the kernels for the level simd() chose (so NN_SIMD caps them too)
+static const OptimizerKernels& optimizerKernels ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    switch (simd ().level) {
+        case SIMD_AVX512: return s_optimizerKernelsAvx512;
+        case SIMD_AVX2:   return s_optimizerKernelsAvx2;
+        case SIMD_SSE2:   return s_optimizerKernelsSse2;
+        default:          break;
+    }
+#endif
+    return s_optimizerKernelsScalar;
+}
+
+// float uses the vector kernels, other element types plain loops
+static void sgdUpdate (float* p, const float* d, float rate, size_t n)
+{
+    simd ().axpy (p, d, rate, n);
+}
+static void momentumUpdate (float* p, float* v, const float* d, float rate, float beta, size_t n)
+{
+    optimizerKernels ().momentum (p, v, d, rate, beta, n);
+}
+static void rmspropUpdate (float* p, float* s, const float* d, float rate, float beta, float epsilon, size_t n)
+{
+    optimizerKernels ().rmsprop (p, s, d, rate, beta, epsilon, n);
+}
+static void adamUpdate (float* p, float* m, float* v, const float* d, float step,
+                        float beta1, float beta2, float epsilon, size_t n)
+{
+    optimizerKernels ().adam (p, m, v, d, step, beta1, beta2, epsilon, n);
+}
+
+template <typename E>
+static void sgdUpdate (E* p, const E* d, E rate, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        p[i] += d[i] * rate;
+    }
+}
+template <typename E>
+static void momentumUpdate (E* p, E* v, const E* d, E rate, E beta, size_t n)
+{
+    momentumLoop<E, E> (p, v, d, rate, beta, n);
+}
+template <typename E>
+static void rmspropUpdate (E* p, E* s, const E* d, E rate, E beta, E epsilon, size_t n)
+{
+    rmspropLoop<E, E> (p, s, d, rate, beta, epsilon, n);
+}
+template <typename E>
+static void adamUpdate (E* p, E* m, E* v, const E* d, E step, E beta1, E beta2, E epsilon, size_t n)
+{
+    adamLoop<E, E> (p, m, v, d, step, beta1, beta2, epsilon, n);
+}
+
+template <typename T>
+BasicOptimizer<T>::BasicOptimizer (Network& network, OptimizerKind kind, Scalar rate)
+    : m_network (network),
+      m_kind (kind),
+      m_rate (rate),
+      m_steps (0)
+{
+    m_count = network.parameterSize ();
+    size_t size = Workspace::footprint (m_count, sizeof(T));
+
+    m_gradientBlock = Workspace (size);
+    network.bindLayers ((T*) m_gradientBlock.m_data, m_gradients);
+
+    // only the state this kind uses
+    size_t states = (kind == OPTIMIZER_ADAM) ? 2 : (kind == OPTIMIZER_SGD) ? 0 : 1;
+    for (size_t s = 0; s < states; ++s) {
+        m_stateBlocks[s] = Workspace (size);
+        network.bindLayers ((T*) m_stateBlocks[s].m_data, m_state[s]);
+    }
+    reset ();
+}
+
+template <typename T>
+BasicOptimizer<T>::~BasicOptimizer ()
+{
+    if (m_network.m_optimizer == this) {
+        m_network.m_optimizer = nullptr;
+    }
+}
+
+//========================================================================
+
+// Zeroes the state and the step count
+template <typename T>
+void BasicOptimizer<T>::reset ()
+{
+    for (size_t s = 0; s < 2; ++s) {
+        if (m_stateBlocks[s].m_data) {
+            memset (m_stateBlocks[s].m_data, 0, m_stateBlocks[s].m_capacity * sizeof(float));
+        }
+    }
+    m_steps = 0;
+}
+
+// Trains on batchSize samples with one update
+template <typename T>
+void BasicOptimizer<T>::trainBatch (const T* inputs, const T* answers, size_t batchSize)
+{
+    if (m_network.parameterSize () != m_count) {
+        printf ("error: the network's layer sizes changed since the optimizer was made\n");
+        return;
+    }
+
+    // direction averaged over the batch
+    memset (m_gradientBlock.m_data, 0, m_gradientBlock.m_capacity * sizeof(float));
+    m_network.accumulateGradients (inputs, answers, batchSize, Scalar (1) / batchSize, m_gradients);
+    apply ((const T*) m_gradientBlock.m_data);
+}
+
+// Trains on the samples in the rows of views with one update
+template <typename T>
+void BasicOptimizer<T>::trainBatch (const View& inputs, const View& answers)
+{
+    if (m_network.parameterSize () != m_count) {
+        printf ("error: the network's layer sizes changed since the optimizer was made\n");
+        return;
+    }
+
+    memset (m_gradientBlock.m_data, 0, m_gradientBlock.m_capacity * sizeof(float));
+    m_network.accumulateGradients (inputs, answers, Scalar (1) / inputs.m_rows, m_gradients);
+    apply ((const T*) m_gradientBlock.m_data);
+}
+
+// Trains on a batch of sparse samples with one update
+template <typename T>
+void BasicOptimizer<T>::trainBatch (const SparseMatrix& inputs, const T* answers)
+{
+    if (m_network.parameterSize () != m_count) {
+        printf ("error: the network's layer sizes changed since the optimizer was made\n");
+        return;
+    }
+
+    // the update still covers every parameter (the state of weights that
+    // no sample touches decays too)
+    memset (m_gradientBlock.m_data, 0, m_gradientBlock.m_capacity * sizeof(float));
+    m_network.accumulateGradients (inputs, answers, Scalar (1) / inputs.m_rows, m_gradients);
+    apply ((const T*) m_gradientBlock.m_data);
+}
+
+// Applies one update from a descent direction laid out like the parameters
+template <typename T>
+void BasicOptimizer<T>::apply (const T* direction)
+{
+    // reads the direction, reads and writes the parameters and state
+    // (sqrt and division counted as one flop each)
+#ifdef NN_PROFILE
+    static const uint64_t flops[] = {2, 4, 8, 12};
+    static const uint64_t states[] = {0, 1, 1, 2};
+#endif
+    NN_PROFILE_SCOPE(PROFILE_OPTIMIZER_UPDATE, flops[m_kind] * m_count, (3 + 2 * states[m_kind]) * m_count * sizeof(T));
+
+    // the parameters are one block, layer by layer (see bindLayers)
+    T* parameters = m_network.m_layers.front ().m_weights.m_data;
+    T* first = (T*) m_stateBlocks[0].m_data;
+    T* second = (T*) m_stateBlocks[1].m_data;
+    ++m_steps;
+
+    switch (m_kind) {
+        case OPTIMIZER_SGD:
+            sgdUpdate (parameters, direction, (T) m_rate, m_count);
+            break;
+        case OPTIMIZER_MOMENTUM:
+            momentumUpdate (parameters, first, direction, (T) m_rate, (T) m_beta1, m_count);
+            break;
+        case OPTIMIZER_RMSPROP:
+            rmspropUpdate (parameters, first, direction, (T) m_rate, (T) m_beta2, (T) m_epsilon, m_count);
+            break;
+        case OPTIMIZER_ADAM: {
+            // bias correction folded into the step size and epsilon:
+            // rate * m/(1-b1^t) / (sqrt(v/(1-b2^t)) + eps)
+            //   = step * m / (sqrt(v) + eps * sqrt(1-b2^t))
+            double correction1 = 1.0 - pow (double (m_beta1), double (m_steps));
+            double correction2 = sqrt (1.0 - pow (double (m_beta2), double (m_steps)));
+            T step = T (m_rate * correction2 / correction1);
+            T epsilon = T (m_epsilon * correction2);
+            adamUpdate (parameters, first, second, direction, step, (T) m_beta1, (T) m_beta2, epsilon, m_count);
+            break;
+        }
+    }
+}
+
+//========================================================================
+
+template class BasicOptimizer<float>;
+template class BasicOptimizer<double>;
+
+//========================================================================
@@ -0,0 +1,137 @@
+// Optimizers
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Parameter update rules for training, in place of the plain SGD step
+// the network does by itself:
+//
+//     Optimizer adam (nn, OPTIMIZER_ADAM, 0.01f);
+//     nn.m_optimizer = &adam;
+//     nn.trainBatch (inputs, answers, 64);   // gradients, then an Adam step
+//
+// With an optimizer attached, train and trainBatch (and ParallelTrainer
+// in TRAIN_SYNC mode) compute the batch's gradients into a block laid
+// out like the parameters and hand them to the optimizer. The
+// optimizer's state (velocity, moments) lives in blocks with the same
+// layout, so every weight and bias Matrix has its state at the same
+// offset, on its own cache lines. An update is one fused pass over the
+// whole parameter block: parameters, state and bias correction are read
+// and written once per element, vectorized for the CPU (see simd.hpp).
+//
+// d is the descent direction (-gradient averaged over the batch):
+//
+//   OPTIMIZER_SGD       p += rate * d
+//   OPTIMIZER_MOMENTUM  v = beta1 * v + d
+//                       p += rate * v
+//   OPTIMIZER_RMSPROP   s = beta2 * s + (1 - beta2) * d^2
+//                       p += rate * d / (sqrt(s) + epsilon)
+//   OPTIMIZER_ADAM      m = beta1 * m + (1 - beta1) * d
+//                       v = beta2 * v + (1 - beta2) * d^2
+//                       p += rate * m^ / (sqrt(v^) + epsilon)
+//                       (m^, v^ bias corrected, folded into the step size)
+//
+// TRAIN_HOGWILD workers train on their own and keep using plain SGD.
+//
+//========================================================================
+
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+//========================================================================
+
+#include <vector>
+#include "neuralnet.hpp"
+#include "workspace.hpp"
+
+//========================================================================
+
+enum OptimizerKind
+{
+    OPTIMIZER_SGD,
+    OPTIMIZER_MOMENTUM,
+    OPTIMIZER_RMSPROP,
+    OPTIMIZER_ADAM
+};
+
+// Returns a printable name for a kind
+const char* optimizerName (OptimizerKind kind);
+
+//========================================================================
+
+template <typename T>
+class BasicOptimizer
+{
+
+public:
+    typedef BasicNeuralNetwork<T> Network;
+    typedef typename Network::Layer Layer;
+    typedef typename Network::Scalar Scalar;
+    typedef typename Network::View View;
+    typedef typename Network::SparseMatrix SparseMatrix;
+
+    Network& m_network;
+    OptimizerKind m_kind;
+
+    // step size (replaces the network's m_learning_rate)
+    Scalar m_rate;
+    // momentum / first moment decay
+    Scalar m_beta1 = 0.9;
+    // second moment decay
+    Scalar m_beta2 = 0.999;
+    // keeps the RMSProp / Adam division finite
+    Scalar m_epsilon = 1e-8;
+
+    // updates applied so far (for Adam's bias correction)
+    size_t m_steps;
+
+    // direction of the current batch, laid out like the parameters
+    Workspace m_gradientBlock;
+    std::vector<Layer> m_gradients;
+
+    // optimizer state, laid out like the parameters
+    // momentum: velocity in the first, RMSProp: mean square in the
+    // second, Adam: both moments
+    Workspace m_stateBlocks[2];
+    std::vector<Layer> m_state[2];
+
+    // Ctor
+    // the state starts at zero (see reset)
+    // Note: the network must outlive the optimizer and keep its layer
+    // sizes, the optimizer is not attached until m_optimizer points to it
+    BasicOptimizer (Network& network, OptimizerKind kind, Scalar rate);
+
+    // detaches itself from the network
+    ~BasicOptimizer ();
+
+    BasicOptimizer (const BasicOptimizer&) = delete;
+    BasicOptimizer& operator= (const BasicOptimizer&) = delete;
+
+    // Trains on batchSize samples with one update
+    // (what the network's train and trainBatch call when attached)
+    void trainBatch (const T* inputs, const T* answers, size_t batchSize);
+    void trainBatch (const View& inputs, const View& answers);
+    void trainBatch (const SparseMatrix& inputs, const T* answers);
+
+    // Applies one update from a descent direction laid out like the
+    // parameters (-gradients averaged over a batch, see
+    // accumulateGradients with rate 1 / batchSize)
+    void apply (const T* direction);
+
+    // Zeroes the state and the step count
+    void reset ();
+
+private:
+
+    // elements (of T) in the parameter block, padding included
+    size_t m_count;
+
+};
+
+// Element types (defined in optimizer.cpp)
+typedef BasicOptimizer<float> Optimizer;
+typedef BasicOptimizer<double> OptimizerDouble;
+
+//========================================================================
+
+#endif
@@ -0,0 +1,86 @@
+// Profile Guided Optimization Workload
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// The run `make CONFIG=pgo` profiles to optimize the library:
+// - the XOR training loop of xor.cpp (100000 single sample steps on a
+//   tiny network, where call overhead dominates)
+// - a larger synthetic network (784-128-10) trained one sample at a
+//   time and in batches of 64, then used for inference
+// Keep it representative of real use: code it does not run is optimized
+// as if no profile existed.
+//
+//========================================================================
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include "matrix.hpp"
+#include "neuralnet.hpp"
+
+//========================================================================
+
+int
+main ()
+{
+
+    // === XOR (as in xor.cpp) ===========================================
+
+    NeuralNetwork xorNetwork (2, 10, 1);
+    float trainingInputs[4][2] = {
+        {0, 0},
+        {0, 1},
+        {1, 0},
+        {1, 1}
+    };
+    float trainingOutputs[4][1] = {
+        {0},
+        {1},
+        {1},
+        {0}
+    };
+    for (size_t i = 0; i < 100000; ++i) {
+        int random_index = rand() % 4;
+        xorNetwork.train (trainingInputs[random_index], trainingOutputs[random_index]);
+    }
+    float output[1];
+    size_t correct = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        xorNetwork.feedForwardInto (trainingInputs[i], output);
+        correct += (output[0] >= 0.5f) == (trainingOutputs[i][0] >= 0.5f);
+    }
+
+    // === larger network ================================================
+
+    const size_t samples = 2048;
+    const size_t batch = 64;
+    NeuralNetwork nn (std::vector<size_t> {784, 128, 10});
+    std::vector<float> inputs (samples * nn.m_inputCount);
+    std::vector<float> answers (samples * nn.m_outputCount, 0.0f);
+    std::vector<float> outputs (samples * nn.m_outputCount);
+    for (size_t i = 0; i < inputs.size (); ++i) {
+        inputs[i] = float (rand () % 256) / 255.0f;
+    }
+    for (size_t s = 0; s < samples; ++s) {
+        answers[s * nn.m_outputCount + rand () % nn.m_outputCount] = 1.0f;
+    }
+
+    for (size_t s = 0; s < samples; ++s) {
+        nn.train (&inputs[s * nn.m_inputCount], &answers[s * nn.m_outputCount]);
+    }
+    for (size_t epoch = 0; epoch < 4; ++epoch) {
+        for (size_t s = 0; s + batch <= samples; s += batch) {
+            nn.trainBatch (&inputs[s * nn.m_inputCount], &answers[s * nn.m_outputCount], batch);
+        }
+    }
+    for (size_t s = 0; s < samples; ++s) {
+        nn.feedForwardInto (&inputs[s * nn.m_inputCount], &outputs[s * nn.m_outputCount]);
+    }
+    nn.predictBatch (inputs.data (), outputs.data (), samples);
+
+    printf ("pgo_train: xor %lu/4 correct, output[0] %f\n", correct, outputs[0]);
+
+}
+
+//========================================================================
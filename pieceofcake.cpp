@@ -38,17 +38,17 @@ main ()
     printf ("Training model...\n");
 
     // XOR Problem
-    float** trainingInputs = new float*[4] {
-        new float[3] {10/10000, 4/10000, 7/10000},
-        new float[3] { 5/10000, 2/10000, 2/10000},
-        new float[3] { 4/10000, 2/10000, 1/10000},
-        new float[3] { 100/10000, 10/10000, 1000/10000},
+    float trainingInputs[4][3] = {
+        {10/10000, 4/10000, 7/10000},
+        { 5/10000, 2/10000, 2/10000},
+        { 4/10000, 2/10000, 1/10000},
+        { 100/10000, 10/10000, 1000/10000},
     };
-    float** trainingOutputs = new float*[4] {
-        new float[1] {168/10000},
-        new float[1] {36/10000},
-        new float[1] {24/10000},
-        new float[1] {360000/10000}
+    float trainingOutputs[4][1] = {
+        {168/10000},
+        {36/10000},
+        {24/10000},
+        {360000/10000}
 
     };
 
@@ -64,17 +64,23 @@ main ()
 
     printf ("Using model to predict:\n");
 
+    // the three samples are predicted in one batch
+    float testInputs[3][3] = {
+        {10, 4, 7},
+        {5, 2, 2},
+        {4, 2, 1}
+    };
+    float outputs[3][1];
+    nn.predictBatch (&testInputs[0][0], &outputs[0][0], 3);
+
     printf ("predict([10, 4, 7]) -> ");
-    float* outputs = nn.feedForward (new float[3] {10, 4, 7});
-    printf ("%f\n", outputs[0]*10000);
+    printf ("%f\n", outputs[0][0]*10000);
 
     printf ("predict([5, 2, 2]) -> ");
-    outputs = nn.feedForward (new float[3] {5, 2, 2});
-    printf ("%f\n", outputs[0]*10000);
+    printf ("%f\n", outputs[1][0]*10000);
     
     printf ("predict([4, 2, 1]) -> ");
-    outputs = nn.feedForward (new float[3] {4, 2, 1});
-    printf ("%f\n", outputs[0]*10000);
+    printf ("%f\n", outputs[2][0]*10000);
 
 
 }
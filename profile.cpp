@@ -0,0 +1,196 @@
+// Hot Path Profiler
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <string.h>
+#include <mutex>
+#include <vector>
+#include "profile.hpp"
+
+//========================================================================
+
+std::atomic<uint64_t> g_profileNextDump (0);
+
+// counters of every live thread, plus those of threads that have exited
+// and the totals at the last reset (which snapshots subtract)
+static std::mutex s_mutex;
+static std::vector<ProfileThreadCounters*> s_threads;
+static ProfileCounters s_exited[PROFILE_PHASE_COUNT];
+static ProfileCounters s_baseline[PROFILE_PHASE_COUNT];
+
+static uint64_t s_dumpInterval = 0;
+static FILE* s_dumpFile = nullptr;
+
+//========================================================================
+
+// Registers a thread's counters for as long as the thread lives
+// (folded into s_exited when it exits)
+struct ProfileThread
+{
+    ProfileThreadCounters m_counters[PROFILE_PHASE_COUNT];
+
+    ProfileThread ()
+    {
+        for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+            m_counters[p].m_nanoseconds = 0;
+            m_counters[p].m_calls = 0;
+            m_counters[p].m_flops = 0;
+            m_counters[p].m_bytes = 0;
+        }
+        std::lock_guard<std::mutex> lock (s_mutex);
+        s_threads.push_back (m_counters);
+    }
+
+    ~ProfileThread ()
+    {
+        std::lock_guard<std::mutex> lock (s_mutex);
+        for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+            s_exited[p].m_nanoseconds += m_counters[p].m_nanoseconds;
+            s_exited[p].m_calls += m_counters[p].m_calls;
+            s_exited[p].m_flops += m_counters[p].m_flops;
+            s_exited[p].m_bytes += m_counters[p].m_bytes;
+        }
+        for (size_t i = 0; i < s_threads.size (); ++i) {
+            if (s_threads[i] == m_counters) {
+                s_threads.erase (s_threads.begin () + i);
+                break;
+            }
+        }
+    }
+};
+
+ProfileThreadCounters* profileThreadCounters ()
+{
+    static thread_local ProfileThread s_thread;
+    return s_thread.m_counters;
+}
+
+//========================================================================
+
+const char* profilePhaseName (ProfilePhase phase)
+{
+    switch (phase) {
+        case PROFILE_INFERENCE:       return "inference (total)";
+        case PROFILE_TRAIN:           return "train (total)";
+        case PROFILE_PACK:            return "pack";
+        case PROFILE_FORWARD_PRODUCT: return "forward product";
+        case PROFILE_ACTIVATION:      return "activation";
+        case PROFILE_OUTPUT_ERROR:    return "output error";
+        case PROFILE_BACKPROP_ERRORS: return "backprop errors";
+        case PROFILE_GRADIENTS:       return "gradients";
+        case PROFILE_WEIGHT_UPDATE:   return "weight update";
+        case PROFILE_OPTIMIZER_UPDATE: return "optimizer update";
+        default:                      return "unknown";
+    }
+}
+
+bool profileEnabled ()
+{
+#ifdef NN_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Sums every thread's counters (s_mutex must be held)
+static void sumCounters (ProfileCounters* counters)
+{
+    memcpy (counters, s_exited, sizeof(s_exited));
+    for (size_t t = 0; t < s_threads.size (); ++t) {
+        for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+            const ProfileThreadCounters& thread = s_threads[t][p];
+            counters[p].m_nanoseconds += thread.m_nanoseconds.load (std::memory_order_relaxed);
+            counters[p].m_calls += thread.m_calls.load (std::memory_order_relaxed);
+            counters[p].m_flops += thread.m_flops.load (std::memory_order_relaxed);
+            counters[p].m_bytes += thread.m_bytes.load (std::memory_order_relaxed);
+        }
+    }
+}
+
+void profileSnapshot (ProfileCounters* counters)
+{
+    std::lock_guard<std::mutex> lock (s_mutex);
+    sumCounters (counters);
+    for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+        counters[p].m_nanoseconds -= s_baseline[p].m_nanoseconds;
+        counters[p].m_calls -= s_baseline[p].m_calls;
+        counters[p].m_flops -= s_baseline[p].m_flops;
+        counters[p].m_bytes -= s_baseline[p].m_bytes;
+    }
+}
+
+void profileReset ()
+{
+    // only their own thread writes the counters, so a reset remembers
+    // where they are instead of zeroing them
+    std::lock_guard<std::mutex> lock (s_mutex);
+    sumCounters (s_baseline);
+}
+
+//========================================================================
+
+void profileDump (FILE* out)
+{
+    if (!profileEnabled ()) {
+        fprintf (out, "profiling is off (build with -DNN_PROFILE)\n");
+        return;
+    }
+
+    ProfileCounters counters[PROFILE_PHASE_COUNT];
+    profileSnapshot (counters);
+
+    // phases are shares of all the time in totals
+    uint64_t total = 0;
+    for (size_t p = 0; p < PROFILE_FIRST_PHASE; ++p) {
+        total += counters[p].m_nanoseconds;
+    }
+
+    fprintf (out, "%-20s %12s %7s %12s %10s %10s %10s\n",
+        "phase", "ms", "share", "calls", "ns/call", "GFLOP/s", "GB/s");
+    for (size_t p = 0; p < PROFILE_PHASE_COUNT; ++p) {
+        const ProfileCounters& c = counters[p];
+        if (c.m_calls == 0) {
+            continue;
+        }
+        double seconds = c.m_nanoseconds * 1e-9;
+        fprintf (out, "%-20s %12.3f %6.1f%% %12lu %10.0f %10.3f %10.3f\n",
+            profilePhaseName (ProfilePhase (p)),
+            seconds * 1e3,
+            total ? 100.0 * c.m_nanoseconds / total : 0.0,
+            (unsigned long) c.m_calls,
+            double (c.m_nanoseconds) / c.m_calls,
+            seconds > 0.0 ? c.m_flops / seconds * 1e-9 : 0.0,
+            seconds > 0.0 ? c.m_bytes / seconds * 1e-9 : 0.0);
+    }
+    fflush (out);
+}
+
+void profileDumpEvery (double seconds, FILE* out)
+{
+    std::lock_guard<std::mutex> lock (s_mutex);
+    s_dumpInterval = (seconds > 0.0) ? uint64_t (seconds * 1e9) : 0;
+    s_dumpFile = out;
+    g_profileNextDump.store (s_dumpInterval ? profileNow () + s_dumpInterval : 0, std::memory_order_relaxed);
+}
+
+void profileTick (uint64_t nanoseconds)
+{
+    // one thread dumps, the others carry on
+    uint64_t next = g_profileNextDump.load (std::memory_order_relaxed);
+    if (next == 0 || nanoseconds < next) {
+        return;
+    }
+    FILE* out;
+    {
+        std::lock_guard<std::mutex> lock (s_mutex);
+        if (s_dumpInterval == 0 || !g_profileNextDump.compare_exchange_strong (next, nanoseconds + s_dumpInterval)) {
+            return;
+        }
+        out = s_dumpFile;
+    }
+    profileDump (out);
+}
+
+//========================================================================
@@ -0,0 +1,175 @@
+// Hot Path Profiler
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Per-phase timers and work counters for training and inference,
+// compiled in only when NN_PROFILE is defined:
+//
+//     make EXTRAFLAGS=-DNN_PROFILE bench_train
+//
+// Each phase of feedForward / predictBatch / train / trainBatch is timed
+// by a scoped timer that adds to the phase's nanoseconds and calls, plus
+// the floating point operations and bytes the phase's Matrix operations
+// are estimated to do (from their shapes: a product is 2mkn flops and
+// reads both operands and writes the result once, elementwise operations
+// and sigmoid count one flop per element, bytes assume nothing is cached).
+//
+// Counters are per thread (no shared cache lines on the hot path) and
+// summed when read. Without NN_PROFILE the NN_PROFILE_SCOPE macros expand
+// to nothing and their arguments are not evaluated, the functions below
+// still exist and report zeros.
+//
+// The total phases (inference, train) include the time of the phases
+// inside them. Timing adds two clock reads per phase, noticeable on
+// very small networks.
+//
+//========================================================================
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+//========================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+
+//========================================================================
+
+enum ProfilePhase
+{
+    // totals (include the phases below)
+    PROFILE_INFERENCE,         // feedForward / predictBatch
+    PROFILE_TRAIN,             // train / trainBatch / accumulateGradients
+    // phases
+    PROFILE_PACK,              // copying samples into / out of matrices
+    PROFILE_FORWARD_PRODUCT,   // weights * inputs
+    PROFILE_ACTIVATION,        // + bias, sigmoid
+    PROFILE_OUTPUT_ERROR,      // answers - outputs
+    PROFILE_BACKPROP_ERRORS,   // weights^T * errors
+    PROFILE_GRADIENTS,         // errors * dsigmoid(nodes)
+    PROFILE_WEIGHT_UPDATE,     // weights += rate * gradients * inputs^T, bias
+    PROFILE_OPTIMIZER_UPDATE,  // optimizer step (see optimizer.hpp)
+    PROFILE_PHASE_COUNT
+};
+
+// phases before this one are totals
+#define PROFILE_FIRST_PHASE PROFILE_PACK
+
+struct ProfileCounters
+{
+    uint64_t m_nanoseconds;
+    uint64_t m_calls;
+    uint64_t m_flops;
+    uint64_t m_bytes;
+};
+
+// Returns the name of a phase ("forward product", ...)
+const char* profilePhaseName (ProfilePhase phase);
+
+// Returns true if the library was built with NN_PROFILE
+bool profileEnabled ();
+
+// Fills counters (PROFILE_PHASE_COUNT of them) with the totals of every
+// thread since the start or the last profileReset
+void profileSnapshot (ProfileCounters* counters);
+
+// Zeroes the counters of every thread
+void profileReset ();
+
+// Prints a table of the counters (time, share of the totals, calls,
+// GFLOP/s and GB/s per phase) to out
+void profileDump (FILE* out);
+
+// Dumps a summary to out every seconds or so (checked when a total
+// phase ends), 0 turns it off
+void profileDumpEvery (double seconds, FILE* out = stderr);
+
+//========================================================================
+// Internals used by the macros
+
+// Counters of one thread, written only by that thread (plain relaxed
+// load and store, no locked instructions) and read by snapshots
+struct ProfileThreadCounters
+{
+    std::atomic<uint64_t> m_nanoseconds;
+    std::atomic<uint64_t> m_calls;
+    std::atomic<uint64_t> m_flops;
+    std::atomic<uint64_t> m_bytes;
+};
+
+// The calling thread's counters (registered on first use)
+ProfileThreadCounters* profileThreadCounters ();
+
+// Dumps if the dump interval has passed (called when a total phase ends)
+void profileTick (uint64_t nanoseconds);
+
+extern std::atomic<uint64_t> g_profileNextDump;
+
+static inline uint64_t profileNow ()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+// Times a scope into a phase
+class ProfileScope
+{
+
+public:
+
+    ProfileScope (ProfilePhase phase, uint64_t flops, uint64_t bytes)
+        : m_phase (phase), m_flops (flops), m_bytes (bytes), m_start (profileNow ())
+    { }
+
+    ~ProfileScope ()
+    {
+        uint64_t end = profileNow ();
+        ProfileThreadCounters& counters = profileThreadCounters ()[m_phase];
+        add (counters.m_nanoseconds, end - m_start);
+        add (counters.m_calls, 1);
+        add (counters.m_flops, m_flops);
+        add (counters.m_bytes, m_bytes);
+        if (m_phase < PROFILE_FIRST_PHASE) {
+            uint64_t next = g_profileNextDump.load (std::memory_order_relaxed);
+            if (next != 0 && end >= next) {
+                profileTick (end);
+            }
+        }
+    }
+
+    ProfileScope (const ProfileScope&) = delete;
+    ProfileScope& operator= (const ProfileScope&) = delete;
+
+private:
+
+    static void add (std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store (counter.load (std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    ProfilePhase m_phase;
+    uint64_t m_flops;
+    uint64_t m_bytes;
+    uint64_t m_start;
+
+};
+
+//========================================================================
+
+#define NN_PROFILE_CONCAT2(a, b) a##b
+#define NN_PROFILE_CONCAT(a, b) NN_PROFILE_CONCAT2(a, b)
+
+// Times the rest of the enclosing scope into phase, adding the estimated
+// flops and bytes of its work
+#ifdef NN_PROFILE
+#define NN_PROFILE_SCOPE(phase, flops, bytes) \
+    ProfileScope NN_PROFILE_CONCAT(profileScope, __LINE__) ((phase), (flops), (bytes))
+#else
+#define NN_PROFILE_SCOPE(phase, flops, bytes) do { } while (0)
+#endif
+
+//========================================================================
+
+#endif
@@ -0,0 +1,609 @@
+// INT8 Quantized Inference
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "quantize.hpp"
+#include "simd.hpp"
+
+//========================================================================
+
+// largest input code (7 bits, see quantize.hpp)
+static const int32_t INPUT_CODES = 127;
+// largest weight magnitude
+static const int32_t WEIGHT_CODES = 127;
+
+// predictBatch runs at most this many samples through the network at once
+static const size_t QUANTIZED_BATCH = 64;
+
+// Returns the bytes a row of cols codes takes up (padded to the alignment)
+static size_t rowStride (size_t cols)
+{
+    return (cols + WORKSPACE_ALIGNMENT - 1) / WORKSPACE_ALIGNMENT * WORKSPACE_ALIGNMENT;
+}
+
+//========================================================================
+// INT8 PRODUCTS
+// sums[s*rows + r] = inputs row s . weights row r
+// - inputs: samples x stride uint8 codes
+// - weights: rows x stride int8 codes
+// stride is a multiple of 64 bytes and both are 64 byte aligned
+
+typedef void (*Int8Product) (int32_t* sums, const uint8_t* inputs, const int8_t* weights, size_t samples, size_t rows, size_t stride);
+
+static void int8ProductScalar (int32_t* sums, const uint8_t* inputs, const int8_t* weights, size_t samples, size_t rows, size_t stride)
+{
+    for (size_t s = 0; s < samples; ++s) {
+        const uint8_t* x = inputs + s * stride;
+        for (size_t r = 0; r < rows; ++r) {
+            const int8_t* w = weights + r * stride;
+            int32_t sum = 0;
+            for (size_t k = 0; k < stride; ++k) {
+                sum += int32_t (x[k]) * int32_t (w[k]);
+            }
+            sums[s * rows + r] = sum;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__ ((target ("avx2")))
+static inline int32_t horizontalSum (__m256i v)
+{
+    __m128i sum = _mm_add_epi32 (_mm256_castsi256_si128 (v), _mm256_extracti128_si256 (v, 1));
+    sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, 0x4e));
+    sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, 0xb1));
+    return _mm_cvtsi128_si32 (sum);
+}
+
+// uint8 x int8 pairs summed to int16 (maddubs), then to int32 (madd)
+__attribute__ ((target ("avx2")))
+static inline __m256i dotStep (__m256i sum, __m256i x, const int8_t* w)
+{
+    const __m256i ones = _mm256_set1_epi16 (1);
+    __m256i pairs = _mm256_maddubs_epi16 (x, _mm256_load_si256 ((const __m256i*) w));
+    return _mm256_add_epi32 (sum, _mm256_madd_epi16 (pairs, ones));
+}
+
+// One sample against every row, four rows at a time
+// (so each input vector is loaded once per four rows)
+__attribute__ ((target ("avx2")))
+static inline void sampleAvx2 (int32_t* out, const uint8_t* x, const int8_t* weights, size_t first, size_t rows, size_t stride)
+{
+    size_t r = first;
+    for (; r + 4 <= rows; r += 4) {
+        const int8_t* w = weights + r * stride;
+        __m256i sum0 = _mm256_setzero_si256 ();
+        __m256i sum1 = _mm256_setzero_si256 ();
+        __m256i sum2 = _mm256_setzero_si256 ();
+        __m256i sum3 = _mm256_setzero_si256 ();
+        for (size_t k = 0; k < stride; k += 32) {
+            __m256i xv = _mm256_load_si256 ((const __m256i*) (x + k));
+            sum0 = dotStep (sum0, xv, w + k);
+            sum1 = dotStep (sum1, xv, w + stride + k);
+            sum2 = dotStep (sum2, xv, w + 2 * stride + k);
+            sum3 = dotStep (sum3, xv, w + 3 * stride + k);
+        }
+        out[r]     = horizontalSum (sum0);
+        out[r + 1] = horizontalSum (sum1);
+        out[r + 2] = horizontalSum (sum2);
+        out[r + 3] = horizontalSum (sum3);
+    }
+    for (; r < rows; ++r) {
+        const int8_t* w = weights + r * stride;
+        __m256i sum = _mm256_setzero_si256 ();
+        for (size_t k = 0; k < stride; k += 32) {
+            sum = dotStep (sum, _mm256_load_si256 ((const __m256i*) (x + k)), w + k);
+        }
+        out[r] = horizontalSum (sum);
+    }
+}
+
+// tiles of 2 samples x 4 rows (8 accumulators, each weight vector is
+// used for both samples), the remaining samples one at a time
+__attribute__ ((target ("avx2")))
+static void int8ProductAvx2 (int32_t* sums, const uint8_t* inputs, const int8_t* weights, size_t samples, size_t rows, size_t stride)
+{
+    size_t s = 0;
+    for (; s + 2 <= samples; s += 2) {
+        const uint8_t* x = inputs + s * stride;
+        int32_t* out = sums + s * rows;
+        size_t r = 0;
+        for (; r + 4 <= rows; r += 4) {
+            const int8_t* w = weights + r * stride;
+            __m256i sum[2][4];
+            #pragma GCC unroll 4
+            for (size_t j = 0; j < 4; ++j) {
+                sum[0][j] = _mm256_setzero_si256 ();
+                sum[1][j] = _mm256_setzero_si256 ();
+            }
+            for (size_t k = 0; k < stride; k += 32) {
+                __m256i x0 = _mm256_load_si256 ((const __m256i*) (x + k));
+                __m256i x1 = _mm256_load_si256 ((const __m256i*) (x + stride + k));
+                #pragma GCC unroll 4
+                for (size_t j = 0; j < 4; ++j) {
+                    sum[0][j] = dotStep (sum[0][j], x0, w + j * stride + k);
+                    sum[1][j] = dotStep (sum[1][j], x1, w + j * stride + k);
+                }
+            }
+            #pragma GCC unroll 4
+            for (size_t j = 0; j < 4; ++j) {
+                out[r + j] = horizontalSum (sum[0][j]);
+                out[rows + r + j] = horizontalSum (sum[1][j]);
+            }
+        }
+        sampleAvx2 (out, x, weights, r, rows, stride);
+        sampleAvx2 (out + rows, x + stride, weights, r, rows, stride);
+    }
+    for (; s < samples; ++s) {
+        sampleAvx2 (sums + s * rows, inputs + s * stride, weights, 0, rows, stride);
+    }
+}
+
+// One sample against every row, four rows at a time
+// uint8 x int8 summed straight into int32 (dpbusd)
+__attribute__ ((target ("avx512f,avx512bw,avx512vnni")))
+static inline void sampleVnni (int32_t* out, const uint8_t* x, const int8_t* weights, size_t first, size_t rows, size_t stride)
+{
+    size_t r = first;
+    for (; r + 4 <= rows; r += 4) {
+        const int8_t* w = weights + r * stride;
+        __m512i sum0 = _mm512_setzero_si512 ();
+        __m512i sum1 = _mm512_setzero_si512 ();
+        __m512i sum2 = _mm512_setzero_si512 ();
+        __m512i sum3 = _mm512_setzero_si512 ();
+        for (size_t k = 0; k < stride; k += 64) {
+            __m512i xv = _mm512_load_si512 (x + k);
+            sum0 = _mm512_dpbusd_epi32 (sum0, xv, _mm512_load_si512 (w + k));
+            sum1 = _mm512_dpbusd_epi32 (sum1, xv, _mm512_load_si512 (w + stride + k));
+            sum2 = _mm512_dpbusd_epi32 (sum2, xv, _mm512_load_si512 (w + 2 * stride + k));
+            sum3 = _mm512_dpbusd_epi32 (sum3, xv, _mm512_load_si512 (w + 3 * stride + k));
+        }
+        out[r]     = _mm512_reduce_add_epi32 (sum0);
+        out[r + 1] = _mm512_reduce_add_epi32 (sum1);
+        out[r + 2] = _mm512_reduce_add_epi32 (sum2);
+        out[r + 3] = _mm512_reduce_add_epi32 (sum3);
+    }
+    for (; r < rows; ++r) {
+        const int8_t* w = weights + r * stride;
+        __m512i sum = _mm512_setzero_si512 ();
+        for (size_t k = 0; k < stride; k += 64) {
+            sum = _mm512_dpbusd_epi32 (sum, _mm512_load_si512 (x + k), _mm512_load_si512 (w + k));
+        }
+        out[r] = _mm512_reduce_add_epi32 (sum);
+    }
+}
+
+// tiles of 4 samples x 4 rows (16 accumulators, each weight vector is
+// used for four samples), the remaining samples one at a time
+__attribute__ ((target ("avx512f,avx512bw,avx512vnni")))
+static void int8ProductVnni (int32_t* sums, const uint8_t* inputs, const int8_t* weights, size_t samples, size_t rows, size_t stride)
+{
+    size_t s = 0;
+    for (; s + 4 <= samples; s += 4) {
+        const uint8_t* x = inputs + s * stride;
+        int32_t* out = sums + s * rows;
+        size_t r = 0;
+        for (; r + 4 <= rows; r += 4) {
+            const int8_t* w = weights + r * stride;
+            __m512i sum[4][4];
+            #pragma GCC unroll 4
+            for (size_t i = 0; i < 4; ++i) {
+                #pragma GCC unroll 4
+                for (size_t j = 0; j < 4; ++j) {
+                    sum[i][j] = _mm512_setzero_si512 ();
+                }
+            }
+            for (size_t k = 0; k < stride; k += 64) {
+                __m512i wv[4];
+                #pragma GCC unroll 4
+                for (size_t j = 0; j < 4; ++j) {
+                    wv[j] = _mm512_load_si512 (w + j * stride + k);
+                }
+                #pragma GCC unroll 4
+                for (size_t i = 0; i < 4; ++i) {
+                    __m512i xv = _mm512_load_si512 (x + i * stride + k);
+                    #pragma GCC unroll 4
+                    for (size_t j = 0; j < 4; ++j) {
+                        sum[i][j] = _mm512_dpbusd_epi32 (sum[i][j], xv, wv[j]);
+                    }
+                }
+            }
+            #pragma GCC unroll 4
+            for (size_t i = 0; i < 4; ++i) {
+                #pragma GCC unroll 4
+                for (size_t j = 0; j < 4; ++j) {
+                    out[i * rows + r + j] = _mm512_reduce_add_epi32 (sum[i][j]);
+                }
+            }
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            sampleVnni (out + i * rows, x + i * stride, weights, r, rows, stride);
+        }
+    }
+    for (; s < samples; ++s) {
+        sampleVnni (sums + s * rows, inputs + s * stride, weights, 0, rows, stride);
+    }
+}
+
+#endif
+
+//========================================================================
+// QUANTIZE AND DEQUANTIZE
+// elementwise loops in GCC vector extensions (like simd.cpp), compiled
+// once per instruction set by the kernel sets below
+
+typedef float   v8f   __attribute__ ((vector_size (32)));
+typedef int     v8i   __attribute__ ((vector_size (32)));
+typedef uint8_t v8u8  __attribute__ ((vector_size (8)));
+typedef float   v16f  __attribute__ ((vector_size (64)));
+typedef int     v16i  __attribute__ ((vector_size (64)));
+typedef uint8_t v16u8 __attribute__ ((vector_size (16)));
+
+// codes = clamp (x / scale + zero, 0, 127) rounded half up, for samples
+// of cols floats (one after another), one sample per stride bytes
+// (the padding is zeroed)
+template <typename VF, typename VI, typename VB>
+static inline __attribute__ ((always_inline))
+void quantizeLoop (uint8_t* codes, const float* x, size_t samples, size_t cols, size_t stride, float scale, int32_t zero)
+{
+    const size_t width = sizeof(VF) / sizeof(float);
+    const float inverse = 1.0f / scale;
+    const float offset = float (zero) + 0.5f;
+    const float top = INPUT_CODES + 0.5f;
+    for (size_t s = 0; s < samples; ++s) {
+        const float* in = x + s * cols;
+        uint8_t* out = codes + s * stride;
+        size_t c = 0;
+        for (; c + width <= cols; c += width) {
+            VF v;
+            memcpy (&v, in + c, sizeof(VF));
+            VF low = {};
+            VF high = low + top;
+            v = v * inverse + offset;
+            v = (v < low) ? low : v;
+            v = (v > high) ? high : v;
+            VB b = __builtin_convertvector (__builtin_convertvector (v, VI), VB);
+            memcpy (out + c, &b, sizeof(VB));
+        }
+        for (; c < cols; ++c) {
+            float q = in[c] * inverse + offset;
+            q = (q < 0.0f) ? 0.0f : q;
+            q = (q > top) ? top : q;
+            out[c] = uint8_t (q);
+        }
+        memset (out + cols, 0, stride - cols);
+    }
+}
+
+// outputs = sums * scale + offset, per row of every sample
+template <typename VF, typename VI>
+static inline __attribute__ ((always_inline))
+void dequantizeLoop (float* outputs, const int32_t* sums, size_t samples, size_t rows, const float* scales, const float* offsets)
+{
+    const size_t width = sizeof(VF) / sizeof(float);
+    for (size_t s = 0; s < samples; ++s) {
+        const int32_t* in = sums + s * rows;
+        float* out = outputs + s * rows;
+        size_t r = 0;
+        for (; r + width <= rows; r += width) {
+            VI vi;
+            VF scale, offset;
+            memcpy (&vi, in + r, sizeof(VI));
+            memcpy (&scale, scales + r, sizeof(VF));
+            memcpy (&offset, offsets + r, sizeof(VF));
+            VF v = __builtin_convertvector (vi, VF) * scale + offset;
+            memcpy (out + r, &v, sizeof(VF));
+        }
+        for (; r < rows; ++r) {
+            out[r] = float (in[r]) * scales[r] + offsets[r];
+        }
+    }
+}
+
+//========================================================================
+
+// Table of int8 kernels for one instruction set
+struct Int8Kernels
+{
+    Int8Level level;
+    Int8Product product;
+    void (*quantize) (uint8_t* codes, const float* x, size_t samples, size_t cols, size_t stride, float scale, int32_t zero);
+    void (*dequantize) (float* outputs, const int32_t* sums, size_t samples, size_t rows, const float* scales, const float* offsets);
+};
+
+#define INT8_KERNEL_SET(NAME, TARGET, LEVEL, VF, VI, VB)                                         \
+    TARGET static void quantize##NAME (uint8_t* codes, const float* x, size_t samples,            \
+                                       size_t cols, size_t stride, float scale, int32_t zero)     \
+        { quantizeLoop<VF, VI, VB> (codes, x, samples, cols, stride, scale, zero); }             \
+    TARGET static void dequantize##NAME (float* outputs, const int32_t* sums, size_t samples,     \
+                                         size_t rows, const float* scales, const float* offsets) \
+        { dequantizeLoop<VF, VI> (outputs, sums, samples, rows, scales, offsets); }              \
+    static const Int8Kernels s_int8Kernels##NAME = {                                             \
+        LEVEL, int8Product##NAME, quantize##NAME, dequantize##NAME                               \
+    };
+
+// the scalar set still uses (generic) vectors for the elementwise loops
+INT8_KERNEL_SET (Scalar, , INT8_SCALAR, v8f, v8i, v8u8)
+
+#if defined(__x86_64__) || defined(__i386__)
+INT8_KERNEL_SET (Avx2, __attribute__ ((target ("avx2"))), INT8_AVX2, v8f, v8i, v8u8)
+INT8_KERNEL_SET (Vnni, __attribute__ ((target ("avx512f,avx512bw,avx512vnni"))), INT8_VNNI, v16f, v16i, v16u8)
+#endif
+
+//========================================================================
+
+// Detects the int8 instruction set (CPUID), within the NN_SIMD cap
+static Int8Level detectInt8Level ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    SimdLevel cap = simd ().level;
+    __builtin_cpu_init ();
+    if (cap >= SIMD_AVX512 && __builtin_cpu_supports ("avx512bw") && __builtin_cpu_supports ("avx512vnni")) {
+        return INT8_VNNI;
+    }
+    if (cap >= SIMD_AVX2 && __builtin_cpu_supports ("avx2")) {
+        return INT8_AVX2;
+    }
+#endif
+    return INT8_SCALAR;
+}
+
+static const Int8Kernels* selectInt8Kernels ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    switch (detectInt8Level ()) {
+        case INT8_VNNI: return &s_int8KernelsVnni;
+        case INT8_AVX2: return &s_int8KernelsAvx2;
+        default:        break;
+    }
+#endif
+    return &s_int8KernelsScalar;
+}
+
+static const Int8Kernels& int8Kernels ()
+{
+    static const Int8Kernels* kernels = selectInt8Kernels ();
+    return *kernels;
+}
+
+Int8Level int8Level ()
+{
+    return int8Kernels ().level;
+}
+
+const char* int8LevelName (Int8Level level)
+{
+    switch (level) {
+        case INT8_AVX2: return "avx2-maddubs";
+        case INT8_VNNI: return "avx512-vnni";
+        default:        return "scalar";
+    }
+}
+
+//========================================================================
+
+// Quantizes a trained network, calibrating on count samples
+QuantizedNetwork::QuantizedNetwork (const NeuralNetwork& network, const float* samples, size_t count)
+    : m_layerSizes (network.m_layerSizes),
+      m_inputCount (network.m_inputCount),
+      m_outputCount (network.m_outputCount),
+      m_layers (network.m_layers.size ()),
+      m_fast_activation (network.m_fast_activation)
+{
+    size_t layerCount = m_layers.size ();
+
+    // Calibrate: the range of each layer's inputs over the samples
+    // (the float network is run one sample per row, in chunks)
+    std::vector<float> minimum (layerCount, 0.0f);
+    std::vector<float> maximum (layerCount, 0.0f);
+    if (!samples) {
+        count = 0;
+    }
+    Workspace scratch (Workspace::matrixFootprint (QUANTIZED_BATCH, largestLayer ()) * 2);
+    for (size_t first = 0; first < count; first += QUANTIZED_BATCH) {
+        size_t batchSize = (count - first < QUANTIZED_BATCH) ? count - first : QUANTIZED_BATCH;
+        scratch.reset ();
+        Matrix buffers[2] = {
+            scratch.matrix (batchSize, largestLayer ()),
+            scratch.matrix (batchSize, largestLayer ())
+        };
+
+        // batchSize x inputCount (read in place)
+        Matrix inputs (batchSize, m_inputCount, (float*) samples + first * m_inputCount);
+        const Matrix* x = &inputs;
+        for (size_t l = 0; l < layerCount; ++l) {
+            for (size_t s = 0; s < x->m_rows; ++s) {
+                const float* row = x->m_data + s * x->m_ld;
+                for (size_t i = 0; i < x->m_cols; ++i) {
+                    minimum[l] = (row[i] < minimum[l]) ? row[i] : minimum[l];
+                    maximum[l] = (row[i] > maximum[l]) ? row[i] : maximum[l];
+                }
+            }
+
+            // outputs = sigmoid (inputs * weights^T + bias)
+            const NeuralNetwork::Layer& layer = network.m_layers[l];
+            Matrix& y = buffers[l % 2];
+            Matrix::productNTInto (*x, layer.m_weights, y);
+            for (size_t s = 0; s < batchSize; ++s) {
+                simd ().add (y.m_data + s * y.m_ld, y.m_data + s * y.m_ld, layer.m_bias.m_data, y.m_cols);
+            }
+            // one flat pass unless the rows are padded
+            size_t rows = y.contiguous () ? 1 : y.m_rows;
+            size_t size = y.contiguous () ? y.m_rows * y.m_cols : y.m_cols;
+            for (size_t s = 0; s < rows; ++s) {
+                float* row = y.m_data + s * y.m_ld;
+                if (m_fast_activation) {
+                    simd ().sigmoidFast (row, row, size);
+                }
+                else {
+                    simd ().sigmoid (row, row, size);
+                }
+            }
+            x = &y;
+        }
+    }
+
+    // one block for every layer's weights, scales and offsets
+    size_t size = 0;
+    for (size_t l = 0; l < layerCount; ++l) {
+        size_t rows = m_layerSizes[l + 1];
+        size += Workspace::footprint (rows * rowStride (m_layerSizes[l]), 1);
+        size += Workspace::footprint (rows) * 2;
+    }
+    m_parameters = Workspace (size);
+
+    for (size_t l = 0; l < layerCount; ++l) {
+        const NeuralNetwork::Layer& source = network.m_layers[l];
+        Layer& layer = m_layers[l];
+        layer.m_rows = m_layerSizes[l + 1];
+        layer.m_cols = m_layerSizes[l];
+        layer.m_stride = rowStride (layer.m_cols);
+        layer.m_weights = (int8_t*) m_parameters.allocate (Workspace::footprint (layer.m_rows * layer.m_stride, 1));
+        layer.m_scales = m_parameters.allocate (layer.m_rows);
+        layer.m_offsets = m_parameters.allocate (layer.m_rows);
+
+        // inputs: the calibrated range (always including 0) over 0..127
+        float range = maximum[l] - minimum[l];
+        layer.m_inputScale = (range > 0.0f) ? range / INPUT_CODES : 1.0f;
+        layer.m_inputZero = (int32_t) lrintf (-minimum[l] / layer.m_inputScale);
+
+        // weights: each row's largest magnitude over -127..127
+        for (size_t r = 0; r < layer.m_rows; ++r) {
+            const float* w = source.m_weights.m_data + r * source.m_weights.m_ld;
+            int8_t* q = layer.m_weights + r * layer.m_stride;
+
+            float largest = 0.0f;
+            for (size_t c = 0; c < layer.m_cols; ++c) {
+                largest = (fabsf (w[c]) > largest) ? fabsf (w[c]) : largest;
+            }
+            float scale = (largest > 0.0f) ? largest / WEIGHT_CODES : 1.0f;
+
+            int32_t sum = 0;
+            for (size_t c = 0; c < layer.m_cols; ++c) {
+                q[c] = (int8_t) lrintf (w[c] / scale);
+                sum += q[c];
+            }
+            memset (q + layer.m_cols, 0, layer.m_stride - layer.m_cols);
+
+            // w . x ~= weightScale * inputScale * (q . codes - zero * sum(q))
+            layer.m_scales[r] = scale * layer.m_inputScale;
+            layer.m_offsets[r] = source.m_bias.m_data[r] - float (layer.m_inputZero) * float (sum) * layer.m_scales[r];
+        }
+    }
+}
+
+//========================================================================
+
+// Returns the calling thread's inference scratch
+static Workspace& threadContext ()
+{
+    static thread_local Workspace s_context;
+    return s_context;
+}
+
+// Feeds one sample through the network into outputs
+void QuantizedNetwork::feedForwardInto (const float* inputs, float* outputs) const
+{
+    predictBatch (inputs, outputs, 1, threadContext ());
+}
+
+void QuantizedNetwork::feedForwardInto (const float* inputs, float* outputs, Workspace& context) const
+{
+    predictBatch (inputs, outputs, 1, context);
+}
+
+// Feeds count samples through the network into outputs
+void QuantizedNetwork::predictBatch (const float* inputs, float* outputs, size_t count) const
+{
+    predictBatch (inputs, outputs, count, threadContext ());
+}
+
+void QuantizedNetwork::predictBatch (const float* inputs, float* outputs, size_t count, Workspace& context) const
+{
+    // Ensure arrays are valid
+    if (!inputs || !outputs) {
+        printf ("error: please enter a valid array of inputs and outputs\n");
+        return;
+    }
+
+    // codes, sums and two buffers of node values (one sample per row)
+    size_t chunk = (count < QUANTIZED_BATCH) ? count : QUANTIZED_BATCH;
+    size_t largest = largestLayer ();
+    context.reserve (Workspace::footprint (chunk * largestStride (), 1)
+                   + Workspace::footprint (chunk * largest) * 3);
+
+    const Int8Kernels& kernels = int8Kernels ();
+    for (size_t first = 0; first < count; first += QUANTIZED_BATCH) {
+        size_t batchSize = (count - first < QUANTIZED_BATCH) ? count - first : QUANTIZED_BATCH;
+
+        context.reset ();
+        uint8_t* codes = (uint8_t*) context.allocate (Workspace::footprint (batchSize * largestStride (), 1));
+        int32_t* sums = (int32_t*) context.allocate (batchSize * largest);
+        float* buffers[2] = {
+            context.allocate (batchSize * largest),
+            context.allocate (batchSize * largest)
+        };
+
+        // layer by layer: quantize, int8 product, dequantize + activate
+        // (the last layer writes straight into outputs)
+        const float* x = inputs + first * m_inputCount;
+        for (size_t l = 0; l < m_layers.size (); ++l) {
+            const Layer& layer = m_layers[l];
+            float* y = (l + 1 == m_layers.size ()) ? outputs + first * m_outputCount : buffers[l % 2];
+            size_t size = batchSize * layer.m_rows;
+            kernels.quantize (codes, x, batchSize, layer.m_cols, layer.m_stride, layer.m_inputScale, layer.m_inputZero);
+            kernels.product (sums, codes, layer.m_weights, batchSize, layer.m_rows, layer.m_stride);
+            kernels.dequantize (y, sums, batchSize, layer.m_rows, layer.m_scales, layer.m_offsets);
+            if (m_fast_activation) {
+                simd ().sigmoidFast (y, y, size);
+            }
+            else {
+                simd ().sigmoid (y, y, size);
+            }
+            x = y;
+        }
+    }
+}
+
+//========================================================================
+
+// Returns the memory (in bytes) the weights, scales and offsets take up
+size_t QuantizedNetwork::weightBytes () const
+{
+    size_t bytes = 0;
+    for (size_t l = 0; l < m_layers.size (); ++l) {
+        bytes += m_layers[l].m_rows * (m_layers[l].m_stride + 2 * sizeof(float));
+    }
+    return bytes;
+}
+
+// Returns the number of nodes in the largest layer after the inputs
+size_t QuantizedNetwork::largestLayer () const
+{
+    size_t largest = 0;
+    for (size_t l = 0; l < m_layers.size (); ++l) {
+        largest = (m_layerSizes[l + 1] > largest) ? m_layerSizes[l + 1] : largest;
+    }
+    return largest;
+}
+
+// Returns the longest row of weights in bytes
+size_t QuantizedNetwork::largestStride () const
+{
+    size_t largest = 0;
+    for (size_t l = 0; l < m_layers.size (); ++l) {
+        size_t stride = rowStride (m_layerSizes[l]);
+        largest = (stride > largest) ? stride : largest;
+    }
+    return largest;
+}
+
+//========================================================================
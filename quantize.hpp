@@ -0,0 +1,130 @@
+// INT8 Quantized Inference
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// A QuantizedNetwork is a read-only copy of a trained NeuralNetwork with
+// 8 bit weights, for serving. Each layer computes
+//
+//     outputs = sigmoid (scale * (qweights . qinputs) + offset)
+//
+// - weights are quantized per row (symmetric): one scale per output
+//   node maps the row's largest magnitude to 127
+// - the inputs of every layer are quantized per layer (asymmetric, with
+//   a zero point) to 7 bit codes 0..127, using the value range seen on a
+//   calibration set. Values outside that range are clamped.
+// - products are int8 x uint8 sums in int32, the epilogue dequantizes
+//   (folding the zero point, the scales and the bias into one scale and
+//   offset per row) and applies sigmoid in float
+//
+// Inputs are 7 bit (not 8) so that the pairwise 16 bit sums of the AVX2
+// maddubs instruction (2 * 127 * 127) can never saturate.
+//
+//========================================================================
+
+#ifndef QUANTIZE_HPP
+#define QUANTIZE_HPP
+
+//========================================================================
+
+#include <stdint.h>
+#include <vector>
+#include "neuralnet.hpp"
+#include "workspace.hpp"
+
+//========================================================================
+
+// Instruction sets the int8 products are built for
+enum Int8Level
+{
+    INT8_SCALAR,
+    // maddubs + madd (uint8 x int8 -> int16 pairs -> int32)
+    INT8_AVX2,
+    // AVX-512 VNNI dpbusd (uint8 x int8 -> int32 in one instruction)
+    INT8_VNNI
+};
+
+// Returns the instruction set the int8 products use
+// (the widest this CPU supports, capped by NN_SIMD like simd())
+Int8Level int8Level ();
+
+// Returns a printable name for a level
+const char* int8LevelName (Int8Level level);
+
+//========================================================================
+
+class QuantizedNetwork
+{
+
+public:
+
+    // One quantized layer (every pointer is into m_parameters)
+    struct Layer
+    {
+        // nodes and nodes of the previous layer
+        size_t m_rows;
+        size_t m_cols;
+        // bytes per row of weights (m_cols rounded up to the alignment,
+        // the padding is zero)
+        size_t m_stride;
+        // m_rows x m_stride
+        int8_t* m_weights;
+        // dequantization, per row: value = sum * scale + offset
+        // (offset folds in the bias and the inputs' zero point)
+        float* m_scales;
+        float* m_offsets;
+        // inputs are quantized to clamp (round (x / scale) + zero, 0, 127)
+        float m_inputScale;
+        int32_t m_inputZero;
+    };
+
+    std::vector<size_t> m_layerSizes;
+    size_t m_inputCount;
+    size_t m_outputCount;
+
+    std::vector<Layer> m_layers;
+
+    // every quantized weight, scale and offset in one allocation
+    Workspace m_parameters;
+
+    // same setting as the network it was made from
+    bool m_fast_activation;
+
+    // Quantizes a trained network
+    // param samples - count calibration samples of inputCount values, one
+    // after another, representative of what the network will be fed
+    // (the range of every layer's inputs is measured on them)
+    QuantizedNetwork (const NeuralNetwork& network, const float* samples, size_t count);
+
+    QuantizedNetwork (const QuantizedNetwork&) = delete;
+    QuantizedNetwork& operator= (const QuantizedNetwork&) = delete;
+
+    // INFERENCE
+    // const and thread safe like NeuralNetwork's, a context is any
+    // Workspace (one per thread), else the calling thread's own is used
+
+    // Feeds one sample through the network into outputs
+    void feedForwardInto (const float* inputs, float* outputs) const;
+    void feedForwardInto (const float* inputs, float* outputs, Workspace& context) const;
+
+    // Feeds count samples (one after another) through the network,
+    // up to 64 at a time
+    void predictBatch (const float* inputs, float* outputs, size_t count) const;
+    void predictBatch (const float* inputs, float* outputs, size_t count, Workspace& context) const;
+
+    // Returns the memory (in bytes) the weights, scales and offsets take up
+    size_t weightBytes () const;
+
+private:
+
+    // Returns the number of nodes in the largest layer after the inputs
+    size_t largestLayer () const;
+
+    // Returns the longest row of weights in bytes
+    size_t largestStride () const;
+
+};
+
+//========================================================================
+
+#endif
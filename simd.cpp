@@ -0,0 +1,319 @@
+// SIMD Elementwise Kernels
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include "simd.hpp"
+
+//========================================================================
+
+// Vector types for each width (GCC vector extensions)
+// the same kernel source is compiled once per instruction set below
+typedef float v4f  __attribute__ ((vector_size (16)));
+typedef int   v4i  __attribute__ ((vector_size (16)));
+typedef float v8f  __attribute__ ((vector_size (32)));
+typedef int   v8i  __attribute__ ((vector_size (32)));
+typedef float v16f __attribute__ ((vector_size (64)));
+typedef int   v16i __attribute__ ((vector_size (64)));
+
+enum ElementwiseOp { OP_ADD, OP_SUBTRACT, OP_MULTIPLY };
+
+//========================================================================
+
+// dst = a (op) b
+// V is either float (scalar) or one of the vector types above
+template <typename V, int OP>
+static inline __attribute__ ((always_inline))
+void binaryLoop (float* dst, const float* a, const float* b, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(float);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V va, vb;
+        memcpy (&va, a + i, sizeof(V));
+        memcpy (&vb, b + i, sizeof(V));
+        if      (OP == OP_ADD)      va += vb;
+        else if (OP == OP_SUBTRACT) va -= vb;
+        else                        va *= vb;
+        memcpy (dst + i, &va, sizeof(V));
+    }
+    for (; i < n; i++) {
+        if      (OP == OP_ADD)      dst[i] = a[i] + b[i];
+        else if (OP == OP_SUBTRACT) dst[i] = a[i] - b[i];
+        else                        dst[i] = a[i] * b[i];
+    }
+}
+
+// dst = a (op) s
+template <typename V, int OP>
+static inline __attribute__ ((always_inline))
+void scalarLoop (float* dst, const float* a, float s, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(float);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V va;
+        memcpy (&va, a + i, sizeof(V));
+        if      (OP == OP_ADD)      va += s;
+        else if (OP == OP_SUBTRACT) va -= s;
+        else                        va *= s;
+        memcpy (dst + i, &va, sizeof(V));
+    }
+    for (; i < n; i++) {
+        if      (OP == OP_ADD)      dst[i] = a[i] + s;
+        else if (OP == OP_SUBTRACT) dst[i] = a[i] - s;
+        else                        dst[i] = a[i] * s;
+    }
+}
+
+// dst += s * x
+template <typename V>
+static inline __attribute__ ((always_inline))
+void axpyLoop (float* dst, const float* x, float s, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(float);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V vd, vx;
+        memcpy (&vd, dst + i, sizeof(V));
+        memcpy (&vx, x + i, sizeof(V));
+        vd += vx * s;
+        memcpy (dst + i, &vd, sizeof(V));
+    }
+    for (; i < n; i++) {
+        dst[i] += x[i] * s;
+    }
+}
+
+// returns the sum of a[i] * b[i]
+// each lane keeps its own partial sum, the lanes are added at the end
+template <typename V>
+static inline __attribute__ ((always_inline))
+float dotLoop (const float* a, const float* b, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(float);
+    size_t i = 0;
+    V acc = {};
+    for (; i + width <= n; i += width) {
+        V va, vb;
+        memcpy (&va, a + i, sizeof(V));
+        memcpy (&vb, b + i, sizeof(V));
+        acc += va * vb;
+    }
+    float lanes[sizeof(V) / sizeof(float)];
+    memcpy (lanes, &acc, sizeof(V));
+    float sum = 0.0f;
+    for (size_t l = 0; l < width; l++) {
+        sum += lanes[l];
+    }
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// true if every a[i] == b[i] (float comparison, so 0 == -0 and NaN != NaN)
+// M is the comparison mask type matching V
+template <typename V, typename M>
+static inline __attribute__ ((always_inline))
+bool equalsLoop (const float* a, const float* b, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(float);
+    size_t i = 0;
+    M differs = {};
+    for (; i + width <= n; i += width) {
+        V va, vb;
+        memcpy (&va, a + i, sizeof(V));
+        memcpy (&vb, b + i, sizeof(V));
+        differs |= (va != vb);
+    }
+    int lanes[sizeof(M) / sizeof(int)];
+    memcpy (lanes, &differs, sizeof(M));
+    for (size_t l = 0; l < sizeof(M) / sizeof(int); l++) {
+        if (lanes[l]) return false;
+    }
+    for (; i < n; i++) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+// exp(x) for every lane of x (single precision)
+// x = n*ln(2) + r with |r| <= ln(2)/2, exp(x) = 2^n * p(r)
+// p is a degree 7 polynomial (Cephes expf) or degree 3 when FAST
+// V is a float vector type and VI the int vector type of the same width
+template <typename V, typename VI, bool FAST>
+static inline __attribute__ ((always_inline))
+void expVector (V& x)
+{
+    const float maxX = 88.3762626647949f;
+    const float minX = -87.3365447504019f;
+    x = (x > maxX) ? (V) {} + maxX : x;
+    x = (x < minX) ? (V) {} + minX : x;
+
+    // n = floor(x / ln(2) + 0.5)
+    V fx = x * 1.44269504088896341f + 0.5f;
+    VI n = __builtin_convertvector (fx, VI);
+    n += (VI) (__builtin_convertvector (n, V) > fx);
+
+    // r = x - n*ln(2) (ln(2) split in two for precision)
+    V fn = __builtin_convertvector (n, V);
+    V r = x - fn * 0.693359375f + fn * 2.12194440e-4f;
+
+    V y;
+    if (FAST) {
+        y = ((r * 0.16666667f + 0.5f) * r + 1.0f) * r + 1.0f;
+    }
+    else {
+        V r2 = r * r;
+        y = (((((r * 1.9875691500e-4f + 1.3981999507e-3f) * r
+              + 8.3334519073e-3f) * r + 4.1665795894e-2f) * r
+              + 1.6666665459e-1f) * r + 5.0000001201e-1f) * r2 + r + 1.0f;
+    }
+
+    // scale by 2^n (built directly in the exponent bits)
+    x = y * (V) ((n + 127) << 23);
+}
+
+// dst = 1 / (1 + exp(-a))
+// the tail is run through a padded vector so every element gets the
+// same approximation regardless of its position
+template <typename V, typename VI, bool FAST>
+static inline __attribute__ ((always_inline))
+void sigmoidLoop (float* dst, const float* a, size_t n)
+{
+    const size_t width = sizeof(V) / sizeof(float);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        V x;
+        memcpy (&x, a + i, sizeof(V));
+        x = -x;
+        expVector<V, VI, FAST> (x);
+        x = 1.0f / (1.0f + x);
+        memcpy (dst + i, &x, sizeof(V));
+    }
+    if (i < n) {
+        V x = {};
+        memcpy (&x, a + i, (n - i) * sizeof(float));
+        x = -x;
+        expVector<V, VI, FAST> (x);
+        x = 1.0f / (1.0f + x);
+        memcpy (dst + i, &x, (n - i) * sizeof(float));
+    }
+}
+
+//========================================================================
+
+// Instantiates the full kernel table for one instruction set
+// V/M are used for the simple kernels (float/int for the scalar set)
+// SV/SVI are the vector types for sigmoid (which needs vector int ops,
+// for the scalar set the compiler lowers them to plain code)
+#define SIMD_KERNEL_SET(NAME, TARGET, V, M, SV, SVI)                                        \
+    TARGET static void add##NAME (float* dst, const float* a, const float* b, size_t n)      \
+        { binaryLoop<V, OP_ADD> (dst, a, b, n); }                                           \
+    TARGET static void subtract##NAME (float* dst, const float* a, const float* b, size_t n) \
+        { binaryLoop<V, OP_SUBTRACT> (dst, a, b, n); }                                      \
+    TARGET static void multiply##NAME (float* dst, const float* a, const float* b, size_t n) \
+        { binaryLoop<V, OP_MULTIPLY> (dst, a, b, n); }                                      \
+    TARGET static void addScalar##NAME (float* dst, const float* a, float s, size_t n)       \
+        { scalarLoop<V, OP_ADD> (dst, a, s, n); }                                           \
+    TARGET static void subtractScalar##NAME (float* dst, const float* a, float s, size_t n)  \
+        { scalarLoop<V, OP_SUBTRACT> (dst, a, s, n); }                                      \
+    TARGET static void multiplyScalar##NAME (float* dst, const float* a, float s, size_t n)  \
+        { scalarLoop<V, OP_MULTIPLY> (dst, a, s, n); }                                      \
+    TARGET static void axpy##NAME (float* dst, const float* x, float s, size_t n)            \
+        { axpyLoop<V> (dst, x, s, n); }                                                     \
+    TARGET static float dot##NAME (const float* a, const float* b, size_t n)                 \
+        { return dotLoop<V> (a, b, n); }                                                    \
+    TARGET static bool equals##NAME (const float* a, const float* b, size_t n)               \
+        { return equalsLoop<V, M> (a, b, n); }                                              \
+    TARGET static void sigmoid##NAME (float* dst, const float* a, size_t n)                  \
+        { sigmoidLoop<SV, SVI, false> (dst, a, n); }                                        \
+    TARGET static void sigmoidFast##NAME (float* dst, const float* a, size_t n)              \
+        { sigmoidLoop<SV, SVI, true> (dst, a, n); }                                         \
+    static const SimdKernels s_kernels##NAME = {                                            \
+        SIMD_LEVEL_##NAME,                                                                  \
+        add##NAME, subtract##NAME, multiply##NAME,                                          \
+        addScalar##NAME, subtractScalar##NAME, multiplyScalar##NAME,                        \
+        axpy##NAME, dot##NAME, equals##NAME,                                                \
+        sigmoid##NAME, sigmoidFast##NAME                                                    \
+    };
+
+#define SIMD_LEVEL_Scalar SIMD_SCALAR
+#define SIMD_LEVEL_Sse2   SIMD_SSE2
+#define SIMD_LEVEL_Avx2   SIMD_AVX2
+#define SIMD_LEVEL_Avx512 SIMD_AVX512
+
+SIMD_KERNEL_SET (Scalar, , float, int, v4f, v4i)
+
+#if defined(__x86_64__) || defined(__i386__)
+SIMD_KERNEL_SET (Sse2,   __attribute__ ((target ("sse2"))),    v4f,  v4i,  v4f,  v4i)
+SIMD_KERNEL_SET (Avx2,   __attribute__ ((target ("avx2"))),    v8f,  v8i,  v8f,  v8i)
+SIMD_KERNEL_SET (Avx512, __attribute__ ((target ("avx512f"))), v16f, v16i, v16f, v16i)
+#endif
+
+//========================================================================
+
+// Reads the NN_SIMD cap from the environment
+static SimdLevel requestedLevel ()
+{
+    const char* env = getenv ("NN_SIMD");
+    if (!env)                        return SIMD_AVX512;
+    if (strcmp (env, "scalar") == 0) return SIMD_SCALAR;
+    if (strcmp (env, "sse2") == 0)   return SIMD_SSE2;
+    if (strcmp (env, "avx2") == 0)   return SIMD_AVX2;
+    if (strcmp (env, "avx512") == 0) return SIMD_AVX512;
+    printf ("warning: unknown NN_SIMD value '%s' (ignored)\n", env);
+    return SIMD_AVX512;
+}
+
+// Detects the widest supported instruction set (CPUID)
+static SimdLevel detectLevel ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports ("avx2"))    return SIMD_AVX2;
+    if (__builtin_cpu_supports ("sse2"))    return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+static const SimdKernels* selectKernels ()
+{
+    SimdLevel level = detectLevel ();
+    SimdLevel cap = requestedLevel ();
+    if (cap < level) level = cap;
+
+#if defined(__x86_64__) || defined(__i386__)
+    switch (level) {
+        case SIMD_AVX512: return &s_kernelsAvx512;
+        case SIMD_AVX2:   return &s_kernelsAvx2;
+        case SIMD_SSE2:   return &s_kernelsSse2;
+        default:          break;
+    }
+#endif
+    return &s_kernelsScalar;
+}
+
+//========================================================================
+
+const SimdKernels& simd ()
+{
+    static const SimdKernels* kernels = selectKernels ();
+    return *kernels;
+}
+
+const char* simdLevelName (SimdLevel level)
+{
+    switch (level) {
+        case SIMD_SSE2:   return "sse2";
+        case SIMD_AVX2:   return "avx2";
+        case SIMD_AVX512: return "avx512";
+        default:          return "scalar";
+    }
+}
+
+//========================================================================
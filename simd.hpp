@@ -0,0 +1,68 @@
+// SIMD Elementwise Kernels
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+//========================================================================
+
+#include <stdlib.h>
+
+//========================================================================
+
+// Instruction sets the kernels are built for (in increasing width)
+enum SimdLevel
+{
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+// Table of elementwise kernels over contiguous float arrays
+// dst may alias either source
+struct SimdKernels
+{
+    SimdLevel level;
+
+    // dst = a (op) b
+    void (*add)      (float* dst, const float* a, const float* b, size_t n);
+    void (*subtract) (float* dst, const float* a, const float* b, size_t n);
+    void (*multiply) (float* dst, const float* a, const float* b, size_t n);
+
+    // dst = a (op) scalar
+    void (*addScalar)      (float* dst, const float* a, float s, size_t n);
+    void (*subtractScalar) (float* dst, const float* a, float s, size_t n);
+    void (*multiplyScalar) (float* dst, const float* a, float s, size_t n);
+
+    // dst += s * x
+    void (*axpy) (float* dst, const float* x, float s, size_t n);
+
+    // returns the sum of a[i] * b[i]
+    // (summed in vector lanes, so the order differs from a plain loop)
+    float (*dot) (const float* a, const float* b, size_t n);
+
+    // true if every a[i] == b[i]
+    bool (*equals) (const float* a, const float* b, size_t n);
+
+    // dst = 1 / (1 + exp(-a))  (logistic sigmoid)
+    // - sigmoid: max abs error 8.9e-8 vs the exact function (same as expf)
+    // - sigmoidFast: cubic exp polynomial, max abs error 1.9e-4
+    // both are computed in single precision, in vector lanes
+    void (*sigmoid)     (float* dst, const float* a, size_t n);
+    void (*sigmoidFast) (float* dst, const float* a, size_t n);
+};
+
+// Returns the kernels for the widest instruction set this CPU supports
+// - detected once (CPUID) on first use
+// - the environment variable NN_SIMD=scalar|sse2|avx2|avx512 caps the level
+const SimdKernels& simd ();
+
+// Returns a printable name for a level
+const char* simdLevelName (SimdLevel level);
+
+//========================================================================
+
+#endif
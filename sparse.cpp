@@ -0,0 +1,200 @@
+// Sparse Matrices
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include "sparse.hpp"
+
+//========================================================================
+
+// Ctor
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix (size_t rows, size_t cols)
+    : m_rows (rows),
+      m_cols (cols),
+      m_rowStart (rows + 1, 0)
+{
+}
+
+// Appends a row of count nonzeros
+template <typename T>
+void BasicSparseMatrix<T>::addRow (const uint32_t* columns, const T* values, size_t count)
+{
+    if (count > 0 && (!columns || !values)) {
+        printf ("error: please enter valid arrays of columns and values\n");
+        return;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        if (columns[k] >= m_cols) {
+            printf ("error: column %u is out of range (%lu columns)\n", columns[k], m_cols);
+            return;
+        }
+    }
+
+    m_columns.insert (m_columns.end (), columns, columns + count);
+    m_values.insert (m_values.end (), values, values + count);
+    m_rowStart.push_back (m_columns.size ());
+    ++m_rows;
+}
+
+// Removes every row
+template <typename T>
+void BasicSparseMatrix<T>::clear ()
+{
+    m_rows = 0;
+    m_rowStart.assign (1, 0);
+    m_columns.clear ();
+    m_values.clear ();
+}
+
+// Returns the number of nonzeros stored
+template <typename T>
+size_t BasicSparseMatrix<T>::nonZeros () const
+{
+    return m_columns.size ();
+}
+
+// Returns a sparse copy of dense values
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::fromDense (const T* data, size_t rows, size_t cols)
+{
+    BasicSparseMatrix sparse (0, cols);
+    sparse.m_rowStart.reserve (rows + 1);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            if (data[r * cols + c] != T (0)) {
+                sparse.m_columns.push_back (uint32_t (c));
+                sparse.m_values.push_back (data[r * cols + c]);
+            }
+        }
+        sparse.m_rowStart.push_back (sparse.m_columns.size ());
+    }
+    sparse.m_rows = rows;
+    return sparse;
+}
+
+// Writes the matrix into dense values
+template <typename T>
+void BasicSparseMatrix<T>::toDense (T* data) const
+{
+    for (size_t i = 0; i < m_rows * m_cols; ++i) {
+        data[i] = T (0);
+    }
+    for (size_t r = 0; r < m_rows; ++r) {
+        for (size_t k = m_rowStart[r]; k < m_rowStart[r + 1]; ++k) {
+            data[r * m_cols + m_columns[k]] = m_values[k];
+        }
+    }
+}
+
+//========================================================================
+// PRODUCTS
+// both walk the dense matrix four rows at a time (the rows of weights stay
+// in cache while every sample gathers from or scatters into them), so
+// each costs rows of a times the nonzeros of the samples
+
+// result = a * b^T
+template <typename T>
+void BasicSparseMatrix<T>::productNTInto (const Matrix& a, const BasicSparseMatrix& b, Matrix& result, size_t firstRow)
+{
+    size_t samples = result.m_cols;
+    if (a.m_cols != b.m_cols || a.m_rows != result.m_rows || firstRow + samples > b.m_rows) {
+        printf ("error: sparse product of %lux%lu and rows %lu-%lu of %lux%lu into %lux%lu\n",
+            a.m_rows, a.m_cols, firstRow, firstRow + samples, b.m_rows, b.m_cols, result.m_rows, result.m_cols);
+        return;
+    }
+
+    const size_t* start = b.m_rowStart.data () + firstRow;
+    const uint32_t* columns = b.m_columns.data ();
+    const T* values = b.m_values.data ();
+    size_t cols = a.m_ld;
+    size_t ld = result.m_ld;
+    size_t i = 0;
+    // four rows at a time share the loads of every column and value
+    for (; i + 4 <= a.m_rows; i += 4) {
+        const T* weights = a.m_data + i * cols;
+        T* out = result.m_data + i * ld;
+        for (size_t s = 0; s < samples; ++s) {
+            Scalar sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+            for (size_t k = start[s]; k < start[s + 1]; ++k) {
+                const T* w = weights + columns[k];
+                Scalar value = Scalar (values[k]);
+                sum0 += Scalar (w[0]) * value;
+                sum1 += Scalar (w[cols]) * value;
+                sum2 += Scalar (w[2 * cols]) * value;
+                sum3 += Scalar (w[3 * cols]) * value;
+            }
+            out[s] = T (sum0);
+            out[ld + s] = T (sum1);
+            out[2 * ld + s] = T (sum2);
+            out[3 * ld + s] = T (sum3);
+        }
+    }
+    for (; i < a.m_rows; ++i) {
+        const T* weights = a.m_data + i * cols;
+        T* out = result.m_data + i * ld;
+        for (size_t s = 0; s < samples; ++s) {
+            Scalar sum = 0;
+            for (size_t k = start[s]; k < start[s + 1]; ++k) {
+                sum += Scalar (weights[columns[k]]) * Scalar (values[k]);
+            }
+            out[s] = T (sum);
+        }
+    }
+}
+
+// result += alpha * a * b^T
+template <typename T>
+void BasicSparseMatrix<T>::addProductNT (Scalar alpha, const Matrix& a, const BasicSparseMatrix& b, Matrix& result, size_t firstRow)
+{
+    size_t samples = a.m_cols;
+    if (result.m_cols != b.m_cols || a.m_rows != result.m_rows || firstRow + samples > b.m_rows) {
+        printf ("error: sparse update of %lux%lu by %lux%lu and rows %lu-%lu of %lux%lu\n",
+            result.m_rows, result.m_cols, a.m_rows, a.m_cols, firstRow, firstRow + samples, b.m_rows, b.m_cols);
+        return;
+    }
+
+    const size_t* start = b.m_rowStart.data () + firstRow;
+    const uint32_t* columns = b.m_columns.data ();
+    const T* values = b.m_values.data ();
+    size_t cols = result.m_ld;
+    size_t ld = a.m_ld;
+    size_t i = 0;
+    // four rows at a time share the loads of every column and value
+    for (; i + 4 <= a.m_rows; i += 4) {
+        const T* gradients = a.m_data + i * ld;
+        T* weights = result.m_data + i * cols;
+        for (size_t s = 0; s < samples; ++s) {
+            Scalar scale0 = alpha * Scalar (gradients[s]);
+            Scalar scale1 = alpha * Scalar (gradients[ld + s]);
+            Scalar scale2 = alpha * Scalar (gradients[2 * ld + s]);
+            Scalar scale3 = alpha * Scalar (gradients[3 * ld + s]);
+            for (size_t k = start[s]; k < start[s + 1]; ++k) {
+                T* w = weights + columns[k];
+                Scalar value = Scalar (values[k]);
+                w[0] = T (Scalar (w[0]) + scale0 * value);
+                w[cols] = T (Scalar (w[cols]) + scale1 * value);
+                w[2 * cols] = T (Scalar (w[2 * cols]) + scale2 * value);
+                w[3 * cols] = T (Scalar (w[3 * cols]) + scale3 * value);
+            }
+        }
+    }
+    for (; i < a.m_rows; ++i) {
+        const T* gradients = a.m_data + i * ld;
+        T* weights = result.m_data + i * cols;
+        for (size_t s = 0; s < samples; ++s) {
+            Scalar scale = alpha * Scalar (gradients[s]);
+            for (size_t k = start[s]; k < start[s + 1]; ++k) {
+                weights[columns[k]] = T (Scalar (weights[columns[k]]) + scale * Scalar (values[k]));
+            }
+        }
+    }
+}
+
+//========================================================================
+
+template class BasicSparseMatrix<float>;
+template class BasicSparseMatrix<double>;
+
+//========================================================================
@@ -0,0 +1,93 @@
+// Sparse Matrices
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Compressed sparse row (CSR) matrices for inputs that are mostly zeros
+// (one-hot categoricals, bag of words). Every row is one sample, stored
+// as the columns and values of its nonzeros:
+//
+//     SparseMatrix batch (0, 10000);
+//     uint32_t columns[] = {17, 4242};
+//     float values[] = {1.0f, 3.0f};
+//     batch.addRow (columns, values, 2);
+//     nn.trainBatch (batch, answers);
+//
+// The products take the dense matrix as it is laid out in a network
+// (weights are nodes x inputs, node values nodes x samples), so a layer
+// fed sparse samples costs its node count times the nonzeros instead of
+// times the input count, and its weight update only touches the columns
+// of the inputs that are nonzero.
+//
+//========================================================================
+
+#ifndef SPARSE_HPP
+#define SPARSE_HPP
+
+//========================================================================
+
+#include <stdint.h>
+#include <vector>
+#include "matrix.hpp"
+
+//========================================================================
+
+template <typename T>
+class BasicSparseMatrix
+{
+
+public:
+    typedef BasicMatrix<T> Matrix;
+    typedef typename Matrix::Scalar Scalar;
+
+    size_t m_rows;
+    size_t m_cols;
+
+    // row r's nonzeros are [m_rowStart[r], m_rowStart[r+1]) of
+    // m_columns and m_values (m_rows + 1 entries)
+    std::vector<size_t> m_rowStart;
+    std::vector<uint32_t> m_columns;
+    std::vector<T> m_values;
+
+    // Ctor
+    // rows are added with addRow (or start empty when rows > 0)
+    explicit BasicSparseMatrix (size_t rows = 0, size_t cols = 0);
+
+    // Appends a row of count nonzeros (columns in any order, each < m_cols)
+    void addRow (const uint32_t* columns, const T* values, size_t count);
+
+    // Removes every row (the memory is kept for the next rows)
+    void clear ();
+
+    // Returns the number of nonzeros stored
+    size_t nonZeros () const;
+
+    // Returns a sparse copy of rows x cols dense values (zeros are dropped)
+    static BasicSparseMatrix fromDense (const T* data, size_t rows, size_t cols);
+
+    // Writes the matrix into rows x cols dense values
+    void toDense (T* data) const;
+
+    // PRODUCTS
+    // the samples used are the rows of b starting at firstRow, one for
+    // each column of result (or of a)
+
+    // result = a * b^T
+    // a - nodes x m_cols (e.g. weights), result - nodes x samples
+    static void productNTInto (const Matrix& a, const BasicSparseMatrix& b, Matrix& result, size_t firstRow = 0);
+
+    // result += alpha * a * b^T (the sum of the outer products of the
+    // columns of a and the rows of b)
+    // a - nodes x samples (e.g. gradients), result - nodes x m_cols
+    // only the columns of result where the samples are nonzero change
+    static void addProductNT (Scalar alpha, const Matrix& a, const BasicSparseMatrix& b, Matrix& result, size_t firstRow = 0);
+
+};
+
+// Element types (defined in sparse.cpp)
+typedef BasicSparseMatrix<float> SparseMatrix;
+typedef BasicSparseMatrix<double> SparseMatrixDouble;
+
+//========================================================================
+
+#endif
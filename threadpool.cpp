@@ -0,0 +1,199 @@
+// Persistent Thread Pool
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include <memory>
+#include "threadpool.hpp"
+
+//========================================================================
+
+// set while a thread is running a task (nested parallelFor runs serially)
+static thread_local bool t_inTask = false;
+
+//========================================================================
+
+// Ctor 
+// threadCount counts the calling thread, so threadCount-1 workers are started
+ThreadPool::ThreadPool (size_t threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    m_jobs = nullptr;
+    m_stop = false;
+
+    for (size_t i = 1; i < threadCount; i++) {
+        m_workers.push_back (std::thread (&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool ()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all ();
+    for (size_t i = 0; i < m_workers.size (); i++) {
+        m_workers[i].join ();
+    }
+}
+
+// Returns the number of threads that run tasks (workers + caller)
+size_t ThreadPool::threadCount () const
+{
+    return m_workers.size () + 1;
+}
+
+//========================================================================
+
+// Claims the next index of job (m_mutex must be held)
+// the job leaves m_jobs with its last index, so once every index has
+// been claimed no thread can find it (and it may end with its run call)
+size_t ThreadPool::claim (Job& job)
+{
+    size_t index = job.m_next++;
+    if (job.m_next == job.m_count) {
+        Job** link = &m_jobs;
+        while (*link != &job) {
+            link = &(*link)->m_later;
+        }
+        *link = job.m_later;
+    }
+    return index;
+}
+
+// Runs one index of a job and signals the job when it was the last one
+void ThreadPool::runTask (Job& job, size_t index)
+{
+    t_inTask = true;
+    job.m_call (job.m_context, index);
+    t_inTask = false;
+
+    // the count only changes under the job's lock, so once the caller
+    // sees it reach 0 (under the same lock) nobody touches the job again
+    std::lock_guard<std::mutex> lock (job.m_mutex);
+    if (--job.m_remaining == 0) {
+        job.m_done.notify_all ();
+    }
+}
+
+void ThreadPool::workerLoop ()
+{
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (true) {
+        // sleep until a job is queued
+        m_wake.wait (lock, [this] { return m_stop || m_jobs != nullptr; });
+        if (m_stop) {
+            return;
+        }
+
+        // the oldest job first
+        Job& job = *m_jobs;
+        size_t index = claim (job);
+        lock.unlock ();
+        runTask (job, index);
+        lock.lock ();
+    }
+}
+
+//========================================================================
+
+// Runs call(context, i) for every i in [0, count) and waits for all of them
+void ThreadPool::run (size_t count, Call call, const void* context)
+{
+    // serial when there is nobody to share with (or when nested)
+    if (m_workers.empty () || count <= 1 || t_inTask) {
+        for (size_t i = 0; i < count; i++) {
+            call (context, i);
+        }
+        return;
+    }
+
+    Job job;
+    job.m_call = call;
+    job.m_context = context;
+    job.m_count = count;
+    job.m_next = 0;
+    job.m_later = nullptr;
+    job.m_remaining = count;
+
+    // queue the job behind any others
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        Job** link = &m_jobs;
+        while (*link) {
+            link = &(*link)->m_later;
+        }
+        *link = &job;
+    }
+    m_wake.notify_all ();
+
+    // help out until every index has been claimed
+    while (true) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            if (job.m_next == count) {
+                break;
+            }
+            index = claim (job);
+        }
+        runTask (job, index);
+    }
+
+    // then wait for the indices other threads are still running
+    std::unique_lock<std::mutex> lock (job.m_mutex);
+    job.m_done.wait (lock, [&job] { return job.m_remaining == 0; });
+}
+
+//========================================================================
+
+static std::unique_ptr<ThreadPool> s_pool;
+static std::mutex s_poolMutex;
+
+// Returns the default thread count (NN_NUM_THREADS or hardware threads)
+static size_t defaultThreadCount ()
+{
+    const char* env = getenv ("NN_NUM_THREADS");
+    if (env) {
+        long count = strtol (env, nullptr, 10);
+        if (count > 0) {
+            return count;
+        }
+        printf ("warning: invalid NN_NUM_THREADS value '%s' (ignored)\n", env);
+    }
+    size_t hardware = std::thread::hardware_concurrency ();
+    return hardware > 0 ? hardware : 1;
+}
+
+// Returns the shared pool used by the library (created on first use)
+ThreadPool& ThreadPool::global ()
+{
+    std::lock_guard<std::mutex> lock (s_poolMutex);
+    if (!s_pool) {
+        s_pool.reset (new ThreadPool (defaultThreadCount ()));
+    }
+    return *s_pool;
+}
+
+// Sets the number of threads used by the library (including the caller)
+void setNumThreads (size_t count)
+{
+    if (count == 0) {
+        count = std::thread::hardware_concurrency ();
+    }
+    std::lock_guard<std::mutex> lock (s_poolMutex);
+    s_pool.reset (new ThreadPool (count));
+}
+
+// Returns the number of threads used by the library
+size_t getNumThreads ()
+{
+    return ThreadPool::global ().threadCount ();
+}
+
+//========================================================================
@@ -0,0 +1,103 @@
+// Persistent Thread Pool
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+//========================================================================
+
+#include <stdlib.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//========================================================================
+
+// Pool of worker threads that live for the whole program
+// - a parallelFor call queues one job, idle workers claim its indices
+//   one at a time (so faster threads take more of them)
+// - the thread calling parallelFor works on its own job too
+// - parallelFor called from inside a task runs serially (no nesting)
+// - queueing and running a job does not allocate (the job lives on the
+//   caller's stack and fn is called through a pointer, never copied)
+class ThreadPool
+{
+
+public:
+
+    // Ctor 
+    // threadCount counts the calling thread, so threadCount-1 workers are started
+    explicit ThreadPool (size_t threadCount);
+    ~ThreadPool ();
+
+    ThreadPool (const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    // Returns the number of threads that run tasks (workers + caller)
+    size_t threadCount () const;
+
+    // Runs fn(i) for every i in [0, count) and waits for all of them
+    template <typename Fn>
+    void parallelFor (size_t count, const Fn& fn)
+    {
+        run (count, [] (const void* context, size_t i) { (*(const Fn*) context) (i); }, &fn);
+    }
+
+    // Returns the shared pool used by the library (created on first use)
+    // sized by setNumThreads, else the NN_NUM_THREADS environment variable,
+    // else the number of hardware threads
+    static ThreadPool& global ();
+
+private:
+
+    // Calls fn(context, i), how parallelFor reaches the callable
+    typedef void (*Call) (const void* context, size_t i);
+
+    // One call to parallelFor
+    struct Job
+    {
+        Call m_call;
+        const void* m_context;
+        size_t m_count;
+        // next index to claim and the job after this one in m_jobs
+        // guarded by the pool's m_mutex
+        size_t m_next;
+        Job* m_later;
+        // indices not yet finished, guarded by m_mutex
+        size_t m_remaining;
+        std::mutex m_mutex;
+        std::condition_variable m_done;
+    };
+
+    std::vector<std::thread> m_workers;
+
+    // jobs with indices left to claim, oldest first
+    // (workers sleep while there are none)
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    Job* m_jobs;
+    bool m_stop;
+
+    void run (size_t count, Call call, const void* context);
+    void workerLoop ();
+    size_t claim (Job& job);
+    void runTask (Job& job, size_t index);
+
+};
+
+//========================================================================
+
+// Sets the number of threads used by the library (including the caller)
+// takes effect immediately, 0 means the number of hardware threads
+// Note: must not be called while other threads are using the library
+void setNumThreads (size_t count);
+
+// Returns the number of threads used by the library
+size_t getNumThreads ();
+
+//========================================================================
+
+#endif
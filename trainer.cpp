@@ -0,0 +1,172 @@
+// Data-Parallel Trainer
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include "optimizer.hpp"
+#include "trainer.hpp"
+#include "threadpool.hpp"
+
+//========================================================================
+
+// Returns a printable name for a mode
+const char* trainingModeName (TrainingMode mode)
+{
+    switch (mode) {
+        case TRAIN_SYNC:    return "sync";
+        case TRAIN_HOGWILD: return "hogwild";
+    }
+    return "unknown";
+}
+
+//========================================================================
+
+// Ctor
+// every worker gets a replica of the network that shares its weights
+template <typename T>
+BasicParallelTrainer<T>::BasicParallelTrainer (Network& network, TrainingMode mode, size_t workers)
+    : m_network (network),
+      m_mode (mode)
+{
+    if (workers == 0) {
+        workers = getNumThreads ();
+    }
+
+    for (size_t w = 0; w < workers; ++w) {
+        Network* worker = new Network (network);
+        worker->shareParameters (network);
+        m_workers.push_back (worker);
+    }
+
+    if (m_mode == TRAIN_SYNC) {
+        m_gradientBlocks.resize (workers);
+        m_gradients.resize (workers);
+        for (size_t w = 0; w < workers; ++w) {
+            m_gradientBlocks[w] = Workspace (Workspace::footprint (network.parameterSize (), sizeof(T)));
+            network.bindLayers ((T*) m_gradientBlocks[w].m_data, m_gradients[w]);
+        }
+    }
+}
+
+template <typename T>
+BasicParallelTrainer<T>::~BasicParallelTrainer ()
+{
+    for (size_t w = 0; w < m_workers.size (); ++w) {
+        delete m_workers[w];
+    }
+}
+
+//========================================================================
+
+// Trains on count samples once, in mini-batches
+template <typename T>
+void BasicParallelTrainer<T>::trainEpoch (const T* inputs, const T* answers, size_t count, size_t batchSize)
+{
+    // Ensure inputs are valid
+    if (!inputs || !answers || batchSize == 0) {
+        printf ("error: please enter a valid set of inputs and answers\n");
+        return;
+    }
+
+    // workers follow the network's settings
+    for (size_t w = 0; w < m_workers.size (); ++w) {
+        m_workers[w]->m_learning_rate = m_network.m_learning_rate;
+        m_workers[w]->m_fast_activation = m_network.m_fast_activation;
+    }
+
+    if (m_mode == TRAIN_SYNC) {
+        trainSync (inputs, answers, count, batchSize);
+    }
+    else {
+        trainHogwild (inputs, answers, count, batchSize);
+    }
+}
+
+//========================================================================
+
+// Splits every mini-batch across the workers and applies one update
+template <typename T>
+void BasicParallelTrainer<T>::trainSync (const T* inputs, const T* answers, size_t count, size_t batchSize)
+{
+    size_t inputCount = m_network.m_inputCount;
+    size_t outputCount = m_network.m_outputCount;
+
+    for (size_t first = 0; first < count; first += batchSize) {
+        size_t size = (count - first < batchSize) ? count - first : batchSize;
+
+        // no worker gets an empty shard
+        size_t workers = (size < m_workers.size ()) ? size : m_workers.size ();
+
+        // gradients are averaged over the whole batch
+        // (an optimizer takes the direction and applies its own rate)
+        Scalar rate = (m_network.m_optimizer ? Scalar (1) : m_network.m_learning_rate) / size;
+
+        ThreadPool::global ().parallelFor (workers, [&] (size_t w) {
+            size_t begin = first + size * w / workers;
+            size_t end = first + size * (w + 1) / workers;
+            memset (m_gradientBlocks[w].m_data, 0, m_gradientBlocks[w].m_capacity * sizeof(float));
+            m_workers[w]->accumulateGradients (inputs + begin * inputCount, answers + begin * outputCount, end - begin, rate, m_gradients[w]);
+        });
+
+        reduceGradients (workers);
+
+        // one update with the summed gradients
+        if (m_network.m_optimizer) {
+            m_network.m_optimizer->apply ((const T*) m_gradientBlocks[0].m_data);
+            continue;
+        }
+        std::vector<Layer>& sum = m_gradients[0];
+        for (size_t l = 0; l < sum.size (); ++l) {
+            m_network.m_layers[l].m_weights.add (sum[l].m_weights);
+            m_network.m_layers[l].m_bias.add (sum[l].m_bias);
+        }
+    }
+}
+
+// Sums the gradients of the first count workers into worker 0's
+// level by level: 0+=1, 2+=3, ... then 0+=2, 4+=6, ... and so on
+template <typename T>
+void BasicParallelTrainer<T>::reduceGradients (size_t count)
+{
+    for (size_t stride = 1; stride < count; stride *= 2) {
+        size_t pairs = (count - stride + 2 * stride - 1) / (2 * stride);
+        ThreadPool::global ().parallelFor (pairs, [&] (size_t p) {
+            std::vector<Layer>& into = m_gradients[2 * stride * p];
+            std::vector<Layer>& from = m_gradients[2 * stride * p + stride];
+            for (size_t l = 0; l < into.size (); ++l) {
+                into[l].m_weights.add (from[l].m_weights);
+                into[l].m_bias.add (from[l].m_bias);
+            }
+        });
+    }
+}
+
+//========================================================================
+
+// Gives every worker its own shard of the samples to train on
+// (updates go straight to the shared weights, without locks)
+template <typename T>
+void BasicParallelTrainer<T>::trainHogwild (const T* inputs, const T* answers, size_t count, size_t batchSize)
+{
+    size_t inputCount = m_network.m_inputCount;
+    size_t outputCount = m_network.m_outputCount;
+    size_t workers = m_workers.size ();
+
+    ThreadPool::global ().parallelFor (workers, [&] (size_t w) {
+        size_t begin = count * w / workers;
+        size_t end = count * (w + 1) / workers;
+        for (size_t first = begin; first < end; first += batchSize) {
+            size_t size = (end - first < batchSize) ? end - first : batchSize;
+            m_workers[w]->trainBatch (inputs + first * inputCount, answers + first * outputCount, size);
+        }
+    });
+}
+
+//========================================================================
+// Element types the trainer is built for
+template class BasicParallelTrainer<float>;
+template class BasicParallelTrainer<double>;
+
+//========================================================================
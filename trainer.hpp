@@ -0,0 +1,105 @@
+// Data-Parallel Trainer
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+//
+// Trains one network on several threads at once, each worker thread
+// taking a shard of the samples. Two modes:
+//
+//   TRAIN_SYNC     every mini-batch is split across the workers, each
+//                  computes the gradients of its shard, the gradients are
+//                  summed pairwise (a tree reduction) and applied as one
+//                  update. Same step as trainBatch on the whole batch, up
+//                  to the order the gradients are summed in.
+//
+//   TRAIN_HOGWILD  the samples are split into one shard per worker and
+//                  each worker runs trainBatch over its shard, updating
+//                  the shared weights without any locks (Hogwild!).
+//                  Concurrent updates can overwrite parts of each other,
+//                  which SGD tolerates, in exchange for no waiting.
+//                  (these races are intended, ThreadSanitizer reports them)
+//
+// Workers are network replicas that share the weights of the trained
+// network but have their own node values and scratch. They run on the
+// library's thread pool (so the products inside a worker run serially).
+//
+//========================================================================
+
+#ifndef TRAINER_HPP
+#define TRAINER_HPP
+
+//========================================================================
+
+#include <vector>
+#include "neuralnet.hpp"
+
+//========================================================================
+
+enum TrainingMode
+{
+    TRAIN_SYNC,
+    TRAIN_HOGWILD
+};
+
+// Returns a printable name for a mode
+const char* trainingModeName (TrainingMode mode);
+
+//========================================================================
+
+template <typename T>
+class BasicParallelTrainer
+{
+
+public:
+    typedef BasicNeuralNetwork<T> Network;
+    typedef typename Network::Layer Layer;
+    typedef typename Network::Scalar Scalar;
+
+    Network& m_network;
+    TrainingMode m_mode;
+
+    // one replica per worker, sharing the weights of m_network
+    std::vector<Network*> m_workers;
+
+    // TRAIN_SYNC only: rate * gradients of each worker's shard
+    // one block per worker, laid out like the network's parameters
+    std::vector<Workspace> m_gradientBlocks;
+    std::vector<std::vector<Layer> > m_gradients;
+
+    // Ctor
+    // param workers - number of worker threads (0 means getNumThreads())
+    // Note: the network must outlive the trainer and keep its layer sizes
+    BasicParallelTrainer (Network& network, TrainingMode mode, size_t workers = 0);
+    ~BasicParallelTrainer ();
+
+    BasicParallelTrainer (const BasicParallelTrainer&) = delete;
+    BasicParallelTrainer& operator= (const BasicParallelTrainer&) = delete;
+
+    // Trains on count samples once (one epoch), in mini-batches
+    // param inputs - count samples of inputCount values, one after another
+    // param answers - count samples of outputCount values, one after another
+    // param batchSize - samples per update (TRAIN_SYNC splits each batch
+    //                   across the workers, TRAIN_HOGWILD workers each
+    //                   take batches of this size from their own shard)
+    // uses the network's learning rate and activation settings (TRAIN_SYNC
+    // applies each update with the network's optimizer instead when it has one)
+    void trainEpoch (const T* inputs, const T* answers, size_t count, size_t batchSize);
+
+private:
+
+    void trainSync (const T* inputs, const T* answers, size_t count, size_t batchSize);
+    void trainHogwild (const T* inputs, const T* answers, size_t count, size_t batchSize);
+
+    // Sums the gradients of the first count workers into worker 0's
+    // pairwise, each level of the tree in parallel
+    void reduceGradients (size_t count);
+
+};
+
+// Element types (defined in trainer.cpp)
+typedef BasicParallelTrainer<float> ParallelTrainer;
+typedef BasicParallelTrainer<double> ParallelTrainerDouble;
+
+//========================================================================
+
+#endif
@@ -0,0 +1,141 @@
+// Scratch Memory Workspace
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#include <stdio.h>
+#include "workspace.hpp"
+
+//========================================================================
+
+// number of floats in one alignment unit
+static const size_t FLOATS_PER_LINE = WORKSPACE_ALIGNMENT / sizeof(float);
+
+// Allocates an aligned block of capacity floats
+// capacity is set to 0 if the allocation fails
+static float* allocateBlock (size_t& capacity)
+{
+    if (capacity == 0) {
+        return nullptr;
+    }
+    float* block = (float*) aligned_alloc (WORKSPACE_ALIGNMENT, capacity * sizeof(float));
+    if (!block) {
+        printf ("error: could not allocate a workspace of %lu floats\n", capacity);
+        capacity = 0;
+    }
+    return block;
+}
+
+//========================================================================
+
+// default ctor 
+Workspace::Workspace ()
+{
+    m_data = nullptr;
+    m_capacity = 0;
+    m_used = 0;
+}
+
+// Ctor 
+// Allocates room for the given number of floats
+Workspace::Workspace (size_t capacity)
+{
+    m_capacity = footprint (capacity);
+    m_data = allocateBlock (m_capacity);
+    m_used = 0;
+}
+
+Workspace::Workspace (const Workspace& other)
+{
+    m_capacity = other.m_capacity;
+    m_data = allocateBlock (m_capacity);
+    m_used = 0;
+}
+
+Workspace::Workspace (Workspace&& other) noexcept
+{
+    m_data = other.m_data;
+    m_capacity = other.m_capacity;
+    m_used = other.m_used;
+
+    other.m_data = nullptr;
+    other.m_capacity = 0;
+    other.m_used = 0;
+}
+
+Workspace& Workspace::operator= (const Workspace& other)
+{
+    if (this != &other) {
+        reset ();
+        reserve (other.m_capacity);
+    }
+    return *this;
+}
+
+Workspace& Workspace::operator= (Workspace&& other) noexcept
+{
+    if (this != &other) {
+        free (m_data);
+
+        m_data = other.m_data;
+        m_capacity = other.m_capacity;
+        m_used = other.m_used;
+
+        other.m_data = nullptr;
+        other.m_capacity = 0;
+        other.m_used = 0;
+    }
+    return *this;
+}
+
+Workspace::~Workspace ()
+{
+    free (m_data);
+}
+
+//========================================================================
+
+// Returns the arena space (in floats) count elements take up (rounded up to the alignment)
+size_t Workspace::footprint (size_t count, size_t elementSize)
+{
+    size_t floats = (count * elementSize + sizeof(float) - 1) / sizeof(float);
+    return ((floats + FLOATS_PER_LINE - 1) / FLOATS_PER_LINE) * FLOATS_PER_LINE;
+}
+
+// Grows the arena to hold at least capacity floats
+void Workspace::reserve (size_t capacity)
+{
+    capacity = footprint (capacity);
+    if (capacity <= m_capacity) {
+        return;
+    }
+
+    free (m_data);
+    m_data = allocateBlock (capacity);
+    m_capacity = capacity;
+    m_used = 0;
+}
+
+// Hands out an aligned, uninitialized buffer of count floats
+float* Workspace::allocate (size_t count)
+{
+    // (an arena that failed to allocate has no room)
+    size_t size = footprint (count);
+    if (!m_data || m_used + size > m_capacity) {
+        printf ("error: workspace is out of room\n");
+        printf ("capacity: %lu, used: %lu, requested: %lu\n", m_capacity, m_used, count);
+        return nullptr;
+    }
+
+    float* buffer = m_data + m_used;
+    m_used += size;
+    return buffer;
+}
+
+// Releases every buffer handed out so far
+void Workspace::reset ()
+{
+    m_used = 0;
+}
+
+//========================================================================
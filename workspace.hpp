@@ -0,0 +1,90 @@
+// Scratch Memory Workspace
+// Author: Amy Burnett
+// Date:   October 18 2026
+//========================================================================
+
+#ifndef WORKSPACE_HPP
+#define WORKSPACE_HPP
+
+//========================================================================
+
+#include <stdlib.h>
+#include "matrix.hpp"
+
+//========================================================================
+
+// Alignment (in bytes) of every buffer handed out by a workspace
+const size_t WORKSPACE_ALIGNMENT = 64;
+
+//========================================================================
+
+// Arena of scratch memory for short-lived matrices
+// - one block is allocated up front and carved up by a bump pointer
+// - every buffer starts on a 64 byte boundary
+// - reset() releases everything at once (e.g. at the start of each step)
+// Matrices handed out by matrix() point into the arena and must not be
+// used after the next reset().
+class Workspace
+{
+
+public:
+    float* m_data;
+    // in floats
+    size_t m_capacity;
+    size_t m_used;
+
+    Workspace ();
+    // Ctor 
+    // Allocates room for the given number of floats
+    explicit Workspace (size_t capacity);
+
+    // Copies get a fresh arena of the same capacity (contents are scratch)
+    Workspace (const Workspace& other);
+    Workspace (Workspace&& other) noexcept;
+    Workspace& operator= (const Workspace& other);
+    Workspace& operator= (Workspace&& other) noexcept;
+    ~Workspace ();
+
+    // Returns the arena space (in floats) count elements of elementSize
+    // bytes take up (rounded up to the alignment)
+    static size_t footprint (size_t count, size_t elementSize = sizeof(float));
+
+    // Returns the arena space (in floats) a rows x cols matrix from
+    // matrix() takes up (padded rows included)
+    template <typename T = float>
+    static size_t matrixFootprint (size_t rows, size_t cols)
+    {
+        return footprint (rows * BasicMatrix<T>::paddedStride (rows, cols), sizeof(T));
+    }
+
+    // Grows the arena to hold at least capacity floats
+    // Note: only call between steps, growing invalidates outstanding buffers
+    void reserve (size_t capacity);
+
+    // Hands out an aligned, uninitialized buffer of count floats
+    // returns nullptr if the arena is out of room (or its allocation failed)
+    float* allocate (size_t count);
+
+    // Hands out an uninitialized rows x cols matrix over arena memory
+    // (of float elements unless another element type is given)
+    // its rows are padded like those of a matrix that owns its buffer
+    template <typename T = float>
+    BasicMatrix<T> matrix (size_t rows, size_t cols)
+    {
+        size_t ld = BasicMatrix<T>::paddedStride (rows, cols);
+        T* data = (T*) allocate (matrixFootprint<T> (rows, cols));
+        if (!data) {
+            // fall back to a regular matrix so the caller still works
+            return BasicMatrix<T> (rows, cols);
+        }
+        return BasicMatrix<T> (rows, cols, data, ld);
+    }
+
+    // Releases every buffer handed out so far
+    void reset ();
+
+};
+
+//========================================================================
+
+#endif
@@ -5,11 +5,39 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
 #include "matrix.hpp"
 #include "neuralnet.hpp"
 
 //========================================================================
 
+// Returns the bytes of the file at path (empty if it cannot be read)
+static std::vector<unsigned char> readFile (const char* path)
+{
+    std::vector<unsigned char> data;
+    FILE* file = fopen (path, "rb");
+    if (!file) return data;
+    unsigned char buffer[4096];
+    size_t count;
+    while ((count = fread (buffer, 1, sizeof (buffer), file)) > 0)
+        data.insert (data.end (), buffer, buffer + count);
+    fclose (file);
+    return data;
+}
+
+// Writes the first size bytes of data to the file at path
+static void writeFile (const char* path, const std::vector<unsigned char>& data, size_t size)
+{
+    FILE* file = fopen (path, "wb");
+    if (!file) return;
+    fwrite (data.data (), 1, size, file);
+    fclose (file);
+}
+
+//========================================================================
+
 int 
 main ()
 {
@@ -41,17 +69,17 @@ main ()
     printf ("Training model...\n");
 
     // XOR Problem
-    float** trainingInputs = new float*[4] {
-        new float[2] {0, 0},
-        new float[2] {0, 1},
-        new float[2] {1, 0},
-        new float[2] {1, 1}
+    float trainingInputs[4][2] = {
+        {0, 0},
+        {0, 1},
+        {1, 0},
+        {1, 1}
     };
-    float** trainingOutputs = new float*[4] {
-        new float[1] {0},
-        new float[1] {1},
-        new float[1] {1},
-        new float[1] {0}
+    float trainingOutputs[4][1] = {
+        {0},
+        {1},
+        {1},
+        {0}
     };
 
 
@@ -67,26 +95,72 @@ main ()
     printf ("Using Model to predict XOR results:\n");
 
     bool wasSuccessful = true; 
+    float outputs[1];
     printf ("predict([0,0]) -> ");
-    float* outputs = nn.feedForward (new float[2] {0,0});
+    nn.feedForwardInto (trainingInputs[0], outputs);
     printf ("%d\n", outputs[0] >= 0.5);
     if (outputs[0] >= 0.5) wasSuccessful = false;
 
     printf ("predict([1,0]) -> ");
-    outputs = nn.feedForward (new float[2] {1,0});
+    nn.feedForwardInto (trainingInputs[2], outputs);
     printf ("%d\n", outputs[0] >= 0.5);
     if (outputs[0] < 0.5) wasSuccessful = false;
 
     printf ("predict([0,1]) -> ");
-    outputs = nn.feedForward (new float[2] {0,1});
+    nn.feedForwardInto (trainingInputs[1], outputs);
     printf ("%d\n", outputs[0] >= 0.5);
     if (outputs[0] < 0.5) wasSuccessful = false;
 
     printf ("predict([1,1]) -> ");
-    outputs = nn.feedForward (new float[2] {1,1});
+    nn.feedForwardInto (trainingInputs[3], outputs);
     printf ("%d\n", outputs[0] >= 0.5);
     if (outputs[0] >= 0.5) wasSuccessful = false;
 
+    printf ("============================================================\n");
+
+    // === SAVING AND LOADING ============================================
+
+    printf ("Saving and reloading the model:\n");
+
+    const char* path = "xor.nn";
+    const char* damagedPath = "xor_damaged.nn";
+    bool saved = nn.save (path);
+    NeuralNetwork* loaded = saved ? NeuralNetwork::load (path) : nullptr;
+    bool sameOutputs = loaded != nullptr;
+    for (size_t i = 0; sameOutputs && i < 4; ++i) {
+        float expected[1];
+        nn.feedForwardInto (trainingInputs[i], expected);
+        loaded->feedForwardInto (trainingInputs[i], outputs);
+        if (outputs[0] != expected[0]) sameOutputs = false;
+    }
+    delete loaded;
+    printf ("reloaded model predicts the same? %s\n", sameOutputs ? "yes" : "no");
+    if (!sameOutputs) wasSuccessful = false;
+
+    // a damaged file must be rejected (before anything is sized from it)
+    std::vector<unsigned char> file = readFile (path);
+    writeFile (damagedPath, file, file.size () / 2);
+    NeuralNetwork* truncated = NeuralNetwork::loadMapped (damagedPath);
+    printf ("truncated model rejected? %s\n", truncated ? "no" : "yes");
+    if (truncated) wasSuccessful = false;
+    delete truncated;
+
+    // the hidden layer size (after the header and the input size)
+    uint64_t hugeLayer = uint64_t (1) << 62;
+    size_t hiddenOffset = sizeof (ModelHeader) + sizeof (hugeLayer);
+    if (file.size () >= hiddenOffset + sizeof (hugeLayer))
+        memcpy (&file[hiddenOffset], &hugeLayer, sizeof (hugeLayer));
+    writeFile (damagedPath, file, file.size ());
+    NeuralNetwork* corrupt = NeuralNetwork::loadMapped (damagedPath);
+    printf ("corrupt layer size rejected? %s\n", corrupt ? "no" : "yes");
+    if (corrupt) wasSuccessful = false;
+    delete corrupt;
+
+    remove (path);
+    remove (damagedPath);
+
+    printf ("============================================================\n");
+
     printf ("Successful? ");
     if (wasSuccessful) printf ("yes\n");
     else printf ("no\n");